@@ -34,9 +34,20 @@
 #include <Preferences.h>
 #include <esp_timer.h>
 #include <WiFi.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <TaskScheduler.h>
+#include <mbedtls/ssl_ciphersuites.h>
+#include "cydWeeWXFetch.h"
+#include "cydWeeWXFields.h"
+#include "cydWeeWXJsonArena.h"
+#include "cydWeeWXHandoff.h"
+#include "cydWeeWXFormat.h"
+#include "cydWeeWXWmo.h"
+#include "cydWeeWXSnapshot.h"
+#include "cydWeeWXTime.h"
+#ifdef CYD_WWX_MQTT
+#include <PubSubClient.h>
+#endif  // CYD_WWX_MQTT
 
 // If using WOKWi simulator include simulated WeeWX query
 #ifdef CYD_WWX_RUN_ON_WOKWI
@@ -56,16 +67,6 @@
 char programName[] = "cydWeeWX"; // Program name
 char programVersion[] = "1.1.0";  // program version
 
-enum class cydwwxsensor {
-    TEMPERATURE = 0, 
-    HUMIDITY,
-    WIND, 
-    WIND_GUST, 
-    PRESSURE,
-    RAIN_RATE, 
-    MAX_SENSORS 
-};
-
 enum class cydwwxdimmermode {
   NONE = 0,
   AUTO,
@@ -74,10 +75,21 @@ enum class cydwwxdimmermode {
   MAX_DIMMER_MODES
 };
 
+// WeeWX data file formats, chosen by the data file name
+enum class cydwwxfeedformat {
+  FULL_JSON = 0,        // cyd_weewx.json
+  COMPACT_JSON,         // cyd_weewx_compact.json
+  COMPACT_MSGPACK       // cyd_weewx_compact.msgpack
+};
+
 // WiFi Manager Config
 WiFiManager wm; // global wm instance
 WiFiManagerParameter * wmWeeWXUrl; // global param ( for non blocking w params )
 WiFiManagerParameter * wmCydWeeWXHostname; 
+WiFiManagerParameter * wmStaticIp;
+WiFiManagerParameter * wmStaticGateway;
+WiFiManagerParameter * wmStaticSubnet;
+WiFiManagerParameter * wmStaticDns;
 bool wifiManagerActive = false;
 uint32_t wifiManagerActiveTime = 0;
 String cydWeeWXPassword = String(CYD_WWX_WM_AP_PASSWORD);
@@ -175,6 +187,20 @@ WiFiManagerParameter * ldrLowThresholdHidden;
 // WeeWX setup parameters and preferences storage
 String cydWeeWXUrl = String(CYD_WWX_WEEWX_URL);
 String cydWeeWXHostname = String(CYD_WWX_HOSTNAME);
+String cydWeeWXStaticIp = String();       // Static IP settings, DHCP is used if the IP address is blank
+String cydWeeWXStaticGateway = String();
+String cydWeeWXStaticSubnet = String();
+String cydWeeWXStaticDns = String();
+
+#ifdef CYD_WWX_WIFI_FAST_CONNECT
+// Access point of the last WiFi connection. Kept in Preferences so the next boot can connect to it
+// directly instead of scanning for the network.
+struct cydWeeWXWiFiAccessPoint {
+  char ssid[33];
+  uint8_t bssid[6];
+  uint8_t channel;
+};
+#endif  // CYD_WWX_WIFI_FAST_CONNECT
 uint16_t cydWeeWXBlMin = CYD_WWX_BL_MIN_BRIGHTNESS;
 uint16_t cydWeeWXBlMax = CYD_WWX_BL_MAX_BRIGHTNESS;
 cydwwxdimmermode cydWeeWXBlDimmerMode = (cydwwxdimmermode)CYD_WWX_DEFAULT_DIMMER_MODE;
@@ -189,74 +215,60 @@ int cydWeeWXRiseSetOffset = CYD_WWX_RISE_SET_OFFSET;
 
 int cydWeeWXDimmerStartTimeInMinutes = (CYD_WWX_DIMMER_START_HOUR * 60) + CYD_WWX_DIMMER_START_MINUTE;
 int cydWeeWXDimmerEndTimeInMinutes = (CYD_WWX_DIMMER_END_HOUR * 60) + CYD_WWX_DIMMER_END_MINUTE;
-int cydWeeWXCurrentTimeInMinutes = 0;
-int cydWeeWXSunriseTimeInMinutes = 0;
-int cydWeeWXSunsetTimeInMinutes = 0;
 
 Preferences cydWeeWXPreference;
 bool saveCydWeeWXConfigNow = false;
 
 // Error State tracking and Label text
 int cydWeeWXErrorState = CYD_WWX_NO_ERROR;
-String errorHeaderMessage = String();
-int cydWeeWXErrorStateTimer = 0;
 
 // String Variables for WiFiManager LVGL Label text
 String wifiManagerMessage = String();
 String wifiManagerTimer = String();
 
-// String Variables for WeeWX LVGL Label text
-String location = String();
-String latitude = String();
-String longitude = String();
-String weatherDescription = String();
-String screenHeader = String();
+// String Variables for WeeWX LVGL Label text set on the display side. The main display labels show
+// text in place with lv_label_set_text_static, so it must stay put while a label points at it.
+const char *weatherDescription = "";
+char weatherCodeNotFound[40] = {};         // Description for a weather code with no icon
+char recoveryMessage[CYD_WWX_ERROR_TEXT_LENGTH] = {};  // Weather description in the critical error state
 String lastUpdateTime = String();
 
-String sunrise = String();
-String sunset = String();
-String moonrise = String();
-String moonset = String();
-String moonPhase = String();
-String iconMoonPhase = String();
-
-String iconTemperature = String(WI_THERMOMETER);
-String temperature = String();
-String insideTemperature = String();
-String trendTemperature = String();
-String unitsTemperature = String();
-
-String iconHumidity = String(WI_HUMIDITY);
-String humidity = String();
-String insideHumidity = String();
-String trendHumidity = String();
-String unitsHumidity = String();
-
-String iconWindGust = String(WI_WIND_GUST);
-String windGust = String();
-String trendWindGust = String();
-String unitsWindGust = String();
-String windGustDirection = String();
-
-String iconWind = String(WI_WIND);
-String wind = String();
-String trendWind = String();
-String unitsWind = String();
-String windDirection = String();
-
-String iconPressure = String(WI_BAROMETER);
-String pressure = String();
-String trendPressure = String();
-String unitsPressure = String();
-
-String iconRainRate = String(WI_UMBRELLA);
-String rainRate = String();
-String trendRainRate = String();
-String unitsRainRate = String();
-
-// Weather WMO Icon related variables
-bool isDay = true;
-int weatherCode = 0;
+const char *iconTemperature = WI_THERMOMETER;
+const char *iconHumidity = WI_HUMIDITY;
+const char *iconWindGust = WI_WIND_GUST;
+const char *iconWind = WI_WIND;
+const char *iconPressure = WI_BAROMETER;
+const char *iconRainRate = WI_UMBRELLA;
+
+// Snapshot being built by the network task and whether it changed since it was last published
+cydWeeWXSnapshot networkSnapshot;
+bool networkSnapshotChanged = false;
+
+// Snapshots handed from the network task to the display, and the one being displayed
+cydWeeWXHandoff<cydWeeWXSnapshot> weatherHandoff;
+const cydWeeWXSnapshot *weather = &weatherHandoff.read();
+const cydWeeWXSnapshot placeholderWeather;       // Shown while the first queries after a restart run
+int64_t mainDisplayFillStart = 0;                // When the main display was asked for, 0 once it is complete (usec)
+
+// Station location for the Open-Meteo queries, kept in Preferences so the first query after a boot
+// can run alongside the first WeeWX query. Owned by the network task.
+String stationLatitude = String();
+String stationLongitude = String();
+bool stationLocationChanged = false;              // WeeWX reported a location Open-Meteo has not been asked about
+
+// Settings handed from the display to the network task
+struct cydWeeWXNetworkConfig {
+  String weeWXUrl = String();
+  bool pollingEnabled = false;        // Only query while the main display is shown
+  uint32_t generation = 0;            // Changed to make the network task start over
+#ifdef CYD_WWX_RUN_ON_WOKWI
+  bool wokwiIsDay = true;
+#endif  // CYD_WWX_RUN_ON_WOKWI
+};
+cydWeeWXHandoff<cydWeeWXNetworkConfig> networkConfigHandoff;
+const cydWeeWXNetworkConfig *networkConfig = &networkConfigHandoff.read();
+uint32_t networkConfigGeneration = 0;
+TaskHandle_t networkTaskHandle = NULL;
 
 bool whichReadingsToShow = true;
 
@@ -275,6 +287,206 @@ const trendLimits trendLimitsForSensors[(unsigned int)cydwwxsensor::MAX_SENSORS]
   {.lowLimit=0.5, .highLimit=3.0}     // RAIN_RATE mm/h per hour
 };
 
+// ******************************
+// ArduinoJson related items
+// ******************************
+//
+#ifdef CYD_WWX_JSON_ARENA
+// Shared by the WeeWX and Open-Meteo responses, which are parsed one at a time in the network task
+cydWeeWXArenaAllocator jsonArena;
+#endif  // CYD_WWX_JSON_ARENA
+
+// WeeWX conditional GET validators from the last good response and poll counters
+char weeWXETag[CYD_WWX_FETCH_VALIDATOR_LENGTH] = "";
+char weeWXLastModified[CYD_WWX_FETCH_VALIDATOR_LENGTH] = "";
+uint32_t weeWXPollCount = 0;
+uint32_t weeWXNotModifiedCount = 0;
+
+// WeeWX response body buffer and content hash of the last good response
+char weeWXBody[CYD_WWX_WEEWX_BODY_BUFFER_SIZE];
+#ifdef CYD_WWX_WEEWX_HASH_DEDUPE
+uint32_t weeWXBodyHash = 0;
+bool weeWXBodyHashValid = false;
+uint32_t weeWXUnchangedCount = 0;
+#endif  // CYD_WWX_WEEWX_HASH_DEDUPE
+
+// WeeWX connection counters
+#ifdef CYD_WWX_WEEWX_KEEP_ALIVE
+uint32_t weeWXConnectionReusedCount = 0;
+uint32_t weeWXConnectionNewCount = 0;
+#endif  // CYD_WWX_WEEWX_KEEP_ALIVE
+
+// Incremental WeeWX and Open-Meteo queries, advanced by the network task
+char openMeteoBody[CYD_WWX_OPEN_METEO_BODY_BUFFER_SIZE];
+cydWeeWXFetch weeWXFetch("WeeWX", weeWXBody, sizeof(weeWXBody));
+cydWeeWXFetch openMeteoFetch("Open-Meteo", openMeteoBody, sizeof(openMeteoBody));
+#ifdef CYD_WWX_WEEWX_RESOLVER_CACHE
+cydWeeWXResolver weeWXResolver;                   // Cached WeeWX server address
+#endif  // CYD_WWX_WEEWX_RESOLVER_CACHE
+#ifdef CYD_WWX_WEEWX_GZIP
+tinfl_decompressor weeWXInflater;                 // Inflate state for gzip encoded WeeWX responses
+#endif  // CYD_WWX_WEEWX_GZIP
+#ifdef CYD_WWX_RUN_ON_WOKWI
+// The queries are answered with the recorded responses in cydWeeWXWokwi.h
+cydWeeWXFixtureTransport weeWXFixture(cydWeeWXWokwiHead, cydWeeWXWokwiJSON);
+cydWeeWXFixtureTransport openMeteoFixture(cydWeeWXWokwiHead, cydWeeWXWokwiOpenMeteoJSON);
+#endif  // CYD_WWX_RUN_ON_WOKWI
+#ifdef CYD_WWX_FAULT_INJECTION
+cydWeeWXTlsTransport weeWXNetworkTransport;       // The fault transports need a network transport of their own to wrap
+cydWeeWXTlsTransport openMeteoNetworkTransport;
+#ifdef CYD_WWX_RUN_ON_WOKWI
+cydWeeWXFaultTransport weeWXFaults(&weeWXFixture);
+cydWeeWXFaultTransport openMeteoFaults(&openMeteoFixture);
+#else
+cydWeeWXFaultTransport weeWXFaults(&weeWXNetworkTransport);
+cydWeeWXFaultTransport openMeteoFaults(&openMeteoNetworkTransport);
+#endif  // CYD_WWX_RUN_ON_WOKWI
+#endif  // CYD_WWX_FAULT_INJECTION
+
+#ifdef CYD_WWX_OPEN_METEO_TLS_LEAN_CIPHERS
+// Only offer ECDHE key exchange with AES-128-GCM. Every current server supports these, and the
+// ESP32 has hardware AES and SHA-256, so the handshake and records cost the least CPU.
+const int openMeteoCipherSuites[] = {
+#ifdef MBEDTLS_SSL_PROTO_TLS1_3
+  MBEDTLS_TLS1_3_AES_128_GCM_SHA256,
+#endif  // MBEDTLS_SSL_PROTO_TLS1_3
+  MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+  MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+  0
+};
+#endif  // CYD_WWX_OPEN_METEO_TLS_LEAN_CIPHERS
+uint32_t weeWXHeapBeforeQuery = 0;
+
+// Format of the WeeWX data file being queried
+cydwwxfeedformat weeWXFeedFormat = cydwwxfeedformat::FULL_JSON;
+
+// WeeWX report timing, learned from the generation epoch of each new WeeWX file. The device has no
+// wall clock, so the smallest gap seen between a report being generated and cydWeeWX receiving it is
+// taken as the best case and data staleness is measured from that.
+uint32_t weeWXNextQueryTime = 0;                  // millis() time of the next WeeWX query
+cydWeeWXTimestamp weeWXReportTime;                // Report time of the latest WeeWX data
+int64_t weeWXLastEpoch = 0;                       // Generation epoch of the latest WeeWX data (sec)
+int64_t weeWXClockOffset = INT64_MAX;             // Smallest (uptime - generation epoch) seen (msec)
+int64_t weeWXReportPeriod = 0;                    // Time between WeeWX reports (sec)
+uint32_t weeWXReportPeriodMatches = 0;            // Reports in a row at weeWXReportPeriod
+const uint32_t weeWXStalenessLimits[] = {10, 30, 60, 120, 300};  // Staleness histogram bucket upper limits (sec)
+uint32_t weeWXStalenessCounts[sizeof(weeWXStalenessLimits) / sizeof(weeWXStalenessLimits[0]) + 1] = {};
+int64_t weeWXStalenessTotal = 0;
+int64_t weeWXStalenessMax = 0;
+
+// Recovery from failed WeeWX queries. Each failure backs off the next query. Failures on this side
+// only, see cydwwxqueryfailure, go on to a WiFi reset after CYD_WWX_RECOVERY_WIFI_RESET_AFTER in a row
+// and a reboot when they have gone on for CYD_WWX_RECOVERY_REBOOT_AFTER msec.
+enum class cydwwxqueryfailure {
+  NONE = 0,
+  SERVER,               // The server answered with an error or bad data, or stopped answering
+  LOCAL                 // No IP address, or the name lookup or connect failed
+};
+
+uint32_t recoveryFailures = 0;                    // WeeWX queries failed in a row
+int64_t recoveryStartTime = 0;                    // When the first of them failed (usec)
+uint32_t recoveryLocalFailures = 0;               // WeeWX queries failed on this side in a row
+int64_t recoveryLocalStartTime = 0;               // When the first of them failed (usec)
+uint32_t recoveryCount = 0;                       // Outages recovered from since boot
+int64_t recoveryTotalTime = 0;                    // Total length of those outages (usec)
+
+// Open-Meteo response cache. The current weather code is shown until its interval ends, then the
+// hourly forecast codes take over until the next query. Times are epoch seconds.
+uint32_t openMeteoNextQueryTime = 0;              // millis() time of the next Open-Meteo query
+int64_t openMeteoCurrentTime = 0;                 // Start of the interval the current weather code covers
+int32_t openMeteoInterval = 0;                    // Length of that interval (sec)
+int64_t openMeteoHourlyTimes[CYD_WWX_OPEN_METEO_FORECAST_HOURS] = {};
+int openMeteoHourlyCodes[CYD_WWX_OPEN_METEO_FORECAST_HOURS] = {};
+uint32_t openMeteoHourlyCount = 0;
+uint32_t lastOpenMeteoForecastCheck = 0;
+bool openMeteoFailed = false;                     // The last Open-Meteo query failed
+int stationWeatherCode = -1;                      // Weather code inferred from the station readings, -1 if not known
+
+#ifdef CYD_WWX_WIFI_EVENTS
+// WiFi link state. The WiFi event handler sets the atomics and the network task follows them, pausing
+// the queries while the link is down and starting them again as soon as it is back.
+enum class cydwwxlinkstate {
+  WAITING,                                        // Not connected since boot
+  CONNECTED,
+  DISCONNECTED
+};
+
+std::atomic<bool> wifiLinkUp{false};              // Station has an IP address
+std::atomic<uint32_t> wifiLinkDownCount{0};       // Times the link went down, so a short drop is not missed
+std::atomic<uint32_t> wifiLinkDownTime{0};        // millis() time the link last went down
+std::atomic<uint8_t> wifiDisconnectReason{0};     // wifi_err_reason_t of the last disconnect
+cydwwxlinkstate wifiLinkState = cydwwxlinkstate::WAITING;
+uint32_t wifiLinkDownCountSeen = 0;
+uint32_t wifiOutageStart = 0;                     // millis() time the current outage started
+uint32_t wifiOutageCount = 0;                     // Outages since boot
+int64_t wifiOutageTotalTime = 0;                  // Total length of those outages (msec)
+uint32_t wifiOutageMaxTime = 0;                   // Longest of them (msec)
+#endif  // CYD_WWX_WIFI_EVENTS
+
+#ifdef CYD_WWX_MQTT
+// MQTT subscription to the WeeWX loop packets, run by the network task
+WiFiClient mqttWiFiClient;
+PubSubClient mqttClient(mqttWiFiClient);
+uint32_t mqttLastConnectAttempt = 0;
+bool mqttConnectAttempted = false;
+uint32_t mqttMessageCount = 0;
+uint32_t lastSnapshotPublish = 0;
+bool mqttUnitsMismatchLogged = false;
+
+// weewx-mqtt observation names, without the units suffix it adds (outTemp_C, windSpeed_kph, etc.), and
+// the reading whose WeeWX units the suffix must match. MAX_SENSORS for observations that have no suffix.
+struct mqttFieldKey {
+  const char *name;
+  cydwwxfield field;
+  cydwwxsensor units;
+};
+
+const mqttFieldKey mqttFieldKeys[] = {
+  {.name="outTemp", .field=cydwwxfield::TEMPERATURE, .units=cydwwxsensor::TEMPERATURE},
+  {.name="outHumidity", .field=cydwwxfield::HUMIDITY, .units=cydwwxsensor::MAX_SENSORS},
+  {.name="inTemp", .field=cydwwxfield::INSIDE_TEMPERATURE, .units=cydwwxsensor::TEMPERATURE},
+  {.name="inHumidity", .field=cydwwxfield::INSIDE_HUMIDITY, .units=cydwwxsensor::MAX_SENSORS},
+  {.name="windSpeed", .field=cydwwxfield::WIND, .units=cydwwxsensor::WIND},
+  {.name="windGust", .field=cydwwxfield::WIND_GUST, .units=cydwwxsensor::WIND_GUST},
+  {.name="windDir", .field=cydwwxfield::WIND_DIRECTION, .units=cydwwxsensor::MAX_SENSORS},
+  {.name="barometer", .field=cydwwxfield::PRESSURE, .units=cydwwxsensor::PRESSURE},
+  {.name="rainRate", .field=cydwwxfield::RAIN_RATE, .units=cydwwxsensor::RAIN_RATE}
+};
+
+// weewx-mqtt units suffixes and the WeeWX unit labels they stand for
+struct mqttUnitsKey {
+  const char *suffix;
+  const char *label;
+};
+
+const mqttUnitsKey mqttUnitsKeys[] = {
+  {.suffix="C", .label="°C"},
+  {.suffix="F", .label="°F"},
+  {.suffix="kph", .label="km/h"},
+  {.suffix="mph", .label="mph"},
+  {.suffix="mps", .label="m/s"},
+  {.suffix="knot", .label="knots"},
+  {.suffix="knot2", .label="knots"},
+  {.suffix="mbar", .label="mbar"},
+  {.suffix="hPa", .label="hPa"},
+  {.suffix="kPa", .label="kPa"},
+  {.suffix="inHg", .label="inHg"},
+  {.suffix="mm_per_hour", .label="mm/h"},
+  {.suffix="cm_per_hour", .label="cm/h"},
+  {.suffix="inch_per_hour", .label="in/h"}
+};
+#endif  // CYD_WWX_MQTT
+
+// Longest pass through loop() since the last query report, to show the UI is not stalled
+std::atomic<int32_t> loopMaxPassTime{0};
+
+// Set when new WeeWX readings are available so timer_cb only refreshes labels that changed
+bool weeWXLabelsNeedRefresh = true;
+
+// Field projection filter for the full WeeWX JSON file. Built once in setup() by buildWeeWXFilter() from
+// weeWXFieldKeys and applied in deserializeWeeWXData() so that all other fields are discarded while parsing.
+JsonDocument weeWXFilter;
+
 // ******************************
 // LVGL related variables
 // ******************************
@@ -375,25 +587,21 @@ static lv_obj_t * almanacReadingsGrid;
 //
 // Declare Call Backs so they can be referenced in the Task declarations.
 void tLvglHandlerCB();
-void tWeeWXUpdateCB();
-void tOpenMeteoUpdateCB();
+void tWeatherSnapshotPickupCB();
 void tCydWeeWXTriggerPinCB();
 void tProcessWifiManagerCB();
 void tTimerWifiManagerDisableCB();
 void tTimerWifiManagerCB();
-void tTimerErrorStateCB();
 #ifdef CYD_WWX_LDR_PIN
 void tTimerReadLDRCB();
 #endif // CYD_WWX_LDR_PIN
 
 // Task Declarations
 Task tLvglHandler(CYD_WWX_CALL_LVGL_HANDLER_EVERY, TASK_FOREVER, &tLvglHandlerCB);
-Task tWeeWXUpdate(CYD_WWX_GET_WEEWX_UPDATE_EVERY, TASK_FOREVER, &tWeeWXUpdateCB);
-Task tOpenMeteoUpdate(CYD_WWX_GET_OPENMETEO_UPDATE_EVERY, TASK_FOREVER, &tOpenMeteoUpdateCB);
+Task tWeatherSnapshotPickup(CYD_WWX_SNAPSHOT_PICKUP_EVERY, TASK_FOREVER, &tWeatherSnapshotPickupCB);
 Task tCydWeeWXTriggerPin(CYD_WWX_CHECK_WM_TRIGGER_PIN_EVERY, TASK_FOREVER, &tCydWeeWXTriggerPinCB);
 Task tProcessWifiManager(CYD_WWX_PROCESS_WM_EVERY, TASK_FOREVER, &tProcessWifiManagerCB);
 Task tTimerWifiManager(CYD_WWX_ONE_SECOND_TIMER, TASK_FOREVER, &tTimerWifiManagerCB, NULL, NULL, NULL, tTimerWifiManagerDisableCB);
-Task tTimerErrorState(CYD_WWX_ONE_SECOND_TIMER, TASK_FOREVER, &tTimerErrorStateCB);
 #ifdef CYD_WWX_LDR_PIN
 Task tTimerReadLDR(CYD_WWX_BL_LDR_TIMER, TASK_FOREVER, &tTimerReadLDRCB);
 #endif // CYD_WWX_LDR_PIN
@@ -407,16 +615,373 @@ void tLvglHandlerCB() {
   lv_task_handler();  // let the GUI do its work
 }
 
-// WeeWX Server Query task callback
-void tWeeWXUpdateCB() {
-  getWeeWXData();
+// Weather snapshot pickup task callback
+void tWeatherSnapshotPickupCB() {
+  if (!pickUpWeatherSnapshot() || (currentActiveDisplay != displayname::WEEWX_MAIN)) {
+    return;
+  }
+  // The labels show the snapshot text in place and the snapshot they showed now goes back to the
+  // network task, so point them at the new one before LVGL draws again. No text is copied.
+  refreshWeatherIcon();
+  refreshWeeWXLabels();
+  refreshReadingsGrid();
+  logLvglMemory("tWeatherSnapshotPickupCB");
+  if (mainDisplayFillStart != 0) {
+    // The new main display is filled in as each query finishes instead of at the next display timer
+    if ((weather->generation == networkConfigGeneration) && weather->initialQueriesDone) {
+      lv_refr_now(cydWeeWXDisp);
+      LOG_INFO("tWeatherSnapshotPickupCB", "Main display complete after " << (int32_t)((esp_timer_get_time() - mainDisplayFillStart) / 1000) << " msec.");
+      mainDisplayFillStart = 0;
+    }
+    return;
+  }
+#ifdef CYD_WWX_MQTT
+  // Show MQTT updates right away instead of at the next display redraw
+  if (weather->updateReceivedTime != 0) {
+    lv_refr_now(cydWeeWXDisp);
+    LOG_INFO("tWeatherSnapshotPickupCB", "MQTT update on display after " << (int32_t)((esp_timer_get_time() - weather->updateReceivedTime) / 1000) << " msec.");
+  }
+#endif  // CYD_WWX_MQTT
+}
+
+// Switch the display to the latest snapshot from the network task. Only swaps the snapshot pointer,
+// the caller must move the labels to it straight away. Returns true if there was a new snapshot.
+bool pickUpWeatherSnapshot() {
+  if (!weatherHandoff.update()) {
+    return false;
+  }
+  weather = &weatherHandoff.read();
+  if ((weather->generation != networkConfigGeneration) && (mainDisplayFillStart != 0)) {
+    weather = &placeholderWeather;  // Data from before the restart, keep showing the placeholders
+  }
+  weeWXLabelsNeedRefresh = true;
+  if (weather->generation == networkConfigGeneration) {  // Ignore errors from before a restart
+    setCydWeeWXErrorState(weather->wifiDown ? CYD_WWX_CRITICAL_ERROR : weather->errorState);
+  }
+  return true;
+}
+
+// Hand the WeeWX URL and polling state to the network task. A restart makes it drop what it has
+// and start over with fresh queries.
+void publishNetworkConfig(bool pollingEnabled, bool restart) {
+  if (restart) {
+    networkConfigGeneration += 1;
+  }
+  cydWeeWXNetworkConfig &config = networkConfigHandoff.writeBuffer();
+  config.weeWXUrl = cydWeeWXUrl;
+  config.pollingEnabled = pollingEnabled;
+  config.generation = networkConfigGeneration;
+#ifdef CYD_WWX_RUN_ON_WOKWI
+  config.wokwiIsDay = cydWeeWXWokiIsDay;
+#endif  // CYD_WWX_RUN_ON_WOKWI
+  networkConfigHandoff.publish();
+}
+
+// Network task pinned to the core that is not running loop(). Runs the WeeWX and Open-Meteo
+// queries and publishes a new snapshot to the display whenever the results change.
+void cydWeeWXNetworkTask(void *parameter) {
+  uint32_t generation = 0;
+  bool weeWXQueryDue = false;
+  bool openMeteoQueryDue = false;
+
+  loadStationLocation();
+  for (;;) {
+    if (networkConfigHandoff.update()) {
+      networkConfig = &networkConfigHandoff.read();
+      if (networkConfig->generation != generation) {
+        // Configuration may have changed so start over with an unconditional query
+        generation = networkConfig->generation;
+        weeWXETag[0] = '\0';
+        weeWXLastModified[0] = '\0';
+#ifdef CYD_WWX_WEEWX_HASH_DEDUPE
+        weeWXBodyHashValid = false;
+#endif  // CYD_WWX_WEEWX_HASH_DEDUPE
+        weeWXFetch.close();  // The WeeWX URL may now point at a different server
+        openMeteoFetch.close();
+        weeWXLastEpoch = 0;  // The report timing of a different server has to be learned again
+        weeWXClockOffset = INT64_MAX;
+        weeWXReportPeriod = 0;
+        weeWXReportPeriodMatches = 0;
+        openMeteoHourlyCount = 0;  // The station location may have changed
+        networkSnapshot = cydWeeWXSnapshot();  // Placeholders until the new queries finish
+        networkSnapshot.generation = generation;
+        networkSnapshotChanged = true;
+        weeWXQueryDue = true;
+        openMeteoQueryDue = true;
+      }
+    }
+
+#ifdef CYD_WWX_WIFI_EVENTS
+    bool linkUp = updateWiFiLinkState(weeWXQueryDue, openMeteoQueryDue);
+#else
+    bool linkUp = true;  // getWeeWXData() checks WiFi for each query
+#endif  // CYD_WWX_WIFI_EVENTS
+
+    if (networkConfig->pollingEnabled && linkUp) {
+      uint32_t now = millis();
+#ifndef CYD_WWX_MQTT
+      uint32_t weeWXUpdateEvery = CYD_WWX_GET_WEEWX_UPDATE_EVERY;
+#else
+      // Current readings come from MQTT so WeeWX is only needed for trends and the almanac
+      uint32_t weeWXUpdateEvery = CYD_WWX_MQTT_GET_WEEWX_UPDATE_EVERY;
+      serviceMqtt();
+#endif  // CYD_WWX_MQTT
+      if (weeWXQueryDue || ((int32_t)(now - weeWXNextQueryTime) >= 0)) {
+        weeWXQueryDue = false;
+        weeWXNextQueryTime = now + weeWXUpdateEvery;  // May be moved by scheduleNextWeeWXQuery()
+        getWeeWXData();
+      }
+#ifndef CYD_WWX_WMO_STATION_ONLY
+      if (stationLocationChanged && !openMeteoFetch.isBusy()) {
+        stationLocationChanged = false;  // Any earlier Open-Meteo query was for the old location
+        openMeteoQueryDue = true;
+      }
+      // Open-Meteo needs the station location so it waits for a running WeeWX query if none was saved
+      if ((openMeteoQueryDue || ((int32_t)(now - openMeteoNextQueryTime) >= 0)) && (!weeWXFetch.isBusy() || !stationLatitude.isEmpty())) {
+        openMeteoQueryDue = false;
+        openMeteoNextQueryTime = now + CYD_WWX_GET_OPENMETEO_UPDATE_EVERY;  // May be moved by scheduleNextOpenMeteoQuery()
+        getOpenMeteoData();
+      }
+      if (now - lastOpenMeteoForecastCheck >= CYD_WWX_ONE_SECOND_TIMER) {
+        lastOpenMeteoForecastCheck = now;
+        updateWeatherCode();
+      }
+#else
+      openMeteoQueryDue = false;  // The weather code comes from the station readings
+      stationLocationChanged = false;
+#endif  // CYD_WWX_WMO_STATION_ONLY
+    }
+
+    if (weeWXFetch.isBusy() && !weeWXFetch.step()) {
+      bool wasCritical = (networkSnapshot.errorState == CYD_WWX_CRITICAL_ERROR);
+      processWeeWXResponse();
+      if (wasCritical && (networkSnapshot.errorState != CYD_WWX_CRITICAL_ERROR)) {
+        openMeteoQueryDue = true;  // Open-Meteo queries were skipped during the outage
+      }
+    }
+    if (openMeteoFetch.isBusy() && !openMeteoFetch.step()) {
+      processOpenMeteoResponse();
+    }
+
+    if (!networkSnapshot.initialQueriesDone && !weeWXQueryDue && !openMeteoQueryDue && !stationLocationChanged
+        && !weeWXFetch.isBusy() && !openMeteoFetch.isBusy()) {
+      networkSnapshot.initialQueriesDone = true;
+      networkSnapshotChanged = true;
+    }
+    bool publishSnapshot = networkSnapshotChanged;
+#ifdef CYD_WWX_MQTT
+    // Combine MQTT updates so the display is not repainted for every packet
+    publishSnapshot = publishSnapshot && (!networkSnapshot.initialQueriesDone || (millis() - lastSnapshotPublish >= CYD_WWX_MQTT_REPAINT_EVERY));
+#endif  // CYD_WWX_MQTT
+    if (publishSnapshot) {
+      weatherHandoff.writeBuffer() = networkSnapshot;
+      weatherHandoff.publish();
+      networkSnapshotChanged = false;
+#ifdef CYD_WWX_MQTT
+      lastSnapshotPublish = millis();
+      networkSnapshot.updateReceivedTime = 0;
+#endif  // CYD_WWX_MQTT
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(CYD_WWX_NETWORK_TASK_DELAY));
+  }
+}
+
+#ifdef CYD_WWX_WIFI_EVENTS
+// WiFi event handler, run by the WiFi event task. Only records the link state for the network task.
+void wifiEventCB(arduino_event_id_t event, arduino_event_info_t info) {
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      wifiLinkUp = true;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      wifiDisconnectReason = info.wifi_sta_disconnected.reason;
+      // Fall through
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      if (wifiLinkUp.exchange(false)) {
+        wifiLinkDownTime = millis();
+        wifiLinkDownCount += 1;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// Follow the WiFi link state set by wifiEventCB(). When the link goes down the queries in progress are
+// dropped and no new ones are started. When it comes back the WeeWX and Open-Meteo queries are made due
+// straight away and the outage is logged. Returns true while the link is up.
+bool updateWiFiLinkState(bool &weeWXQueryDue, bool &openMeteoQueryDue) {
+  uint32_t downCount = wifiLinkDownCount;
+  if ((downCount != wifiLinkDownCountSeen) && (wifiLinkState == cydwwxlinkstate::CONNECTED)) {
+    wifiLinkState = cydwwxlinkstate::DISCONNECTED;
+    wifiOutageStart = wifiLinkDownTime;
+    LOG_ERROR("updateWiFiLinkState", "WiFi disconnected, reason: " << (int)wifiDisconnectReason.load() << ". Queries paused.");
+    weeWXFetch.close();  // The connections did not survive the outage
+    openMeteoFetch.close();
+#ifdef CYD_WWX_MQTT
+    mqttClient.disconnect();
+#endif  // CYD_WWX_MQTT
+    networkSnapshot.wifiDown = true;  // Shown as a critical error without touching the query error state
+    networkSnapshot.recoveryRetryTime = wifiOutageStart + CYD_WWX_WIFI_OUTAGE_REBOOT_AFTER;
+    networkSnapshotChanged = true;
+  }
+  wifiLinkDownCountSeen = downCount;
+
+  if (!wifiLinkUp) {
+    if ((wifiLinkState == cydwwxlinkstate::DISCONNECTED) && networkConfig->pollingEnabled
+        && (millis() - wifiOutageStart >= CYD_WWX_WIFI_OUTAGE_REBOOT_AFTER)) {
+      LOG_ERROR("updateWiFiLinkState", "WiFi has been down for " << (millis() - wifiOutageStart) << " msec. Rebooting device.");
+      ESP.restart();
+    }
+    return false;
+  }
+
+  if (wifiLinkState == cydwwxlinkstate::DISCONNECTED) {
+    uint32_t outage = millis() - wifiOutageStart;
+    wifiOutageCount += 1;
+    wifiOutageTotalTime += outage;
+    wifiOutageMaxTime = max(wifiOutageMaxTime, outage);
+    LOG_INFO("updateWiFiLinkState", "WiFi reconnected after " << outage << " msec. Outages: " << wifiOutageCount << ", mean: "
+      << (int32_t)(wifiOutageTotalTime / wifiOutageCount) << " msec, longest: " << wifiOutageMaxTime << " msec.");
+    networkSnapshot.wifiDown = false;
+    networkSnapshotChanged = true;
+    weeWXQueryDue = true;
+    openMeteoQueryDue = true;
+#ifdef CYD_WWX_MQTT
+    mqttConnectAttempted = false;  // Subscribe again straight away
+#endif  // CYD_WWX_MQTT
+  }
+  wifiLinkState = cydwwxlinkstate::CONNECTED;
+  return true;
+}
+#endif  // CYD_WWX_WIFI_EVENTS
+
+#ifdef CYD_WWX_MQTT
+// Keep the MQTT broker connection up and handle any messages that arrived. Called by the network task.
+void serviceMqtt() {
+  if (mqttClient.connected()) {
+    mqttClient.loop();
+    return;
+  }
+  if ((WiFi.status() != WL_CONNECTED) ||
+      (mqttConnectAttempted && (millis() - mqttLastConnectAttempt < CYD_WWX_MQTT_RECONNECT_EVERY))) {
+    return;
+  }
+  mqttConnectAttempted = true;
+  mqttLastConnectAttempt = millis();
+
+  mqttClient.setServer(CYD_WWX_MQTT_BROKER, CYD_WWX_MQTT_PORT);
+  mqttClient.setCallback(mqttMessageCB);
+  mqttClient.setBufferSize(CYD_WWX_MQTT_BUFFER_SIZE);
+  mqttClient.setSocketTimeout(CYD_WWX_MQTT_SOCKET_TIMEOUT);  // connect() blocks the network task until the broker answers
+  String clientId = String(CYD_WWX_HOSTNAME "-") + WiFi.macAddress();
+  const char *user = (strlen(CYD_WWX_MQTT_USER) > 0) ? CYD_WWX_MQTT_USER : NULL;
+  const char *password = (strlen(CYD_WWX_MQTT_USER) > 0) ? CYD_WWX_MQTT_PASSWORD : NULL;
+  if (mqttClient.connect(clientId.c_str(), user, password) && mqttClient.subscribe(CYD_WWX_MQTT_TOPIC)) {
+    LOG_INFO("serviceMqtt", "Subscribed to " << CYD_WWX_MQTT_TOPIC << " on " << CYD_WWX_MQTT_BROKER << ":" << CYD_WWX_MQTT_PORT);
+  } else {
+    LOG_ERROR("serviceMqtt", "MQTT connection to " << CYD_WWX_MQTT_BROKER << " failed, state: " << mqttClient.state());
+  }
+}
+
+// True if the units suffix of a weewx-mqtt observation is the units the WeeWX data file reports for the
+// reading. Until the first WeeWX query has set the units, or for units not in mqttUnitsKeys, it is false.
+bool mqttUnitsMatch(const mqttFieldKey &key, const char *name, const char *suffix) {
+  if (key.units == cydwwxsensor::MAX_SENSORS) {
+    return true;
+  }
+  const char *units = networkSnapshot.reading(key.units).units;
+  while (*units == ' ') {
+    units++;
+  }
+  if (*units == '\0') {
+    return false;
+  }
+  for (const mqttUnitsKey &unitsKey : mqttUnitsKeys) {
+    if (strcmp(unitsKey.suffix, suffix) == 0) {
+      if (strcmp(unitsKey.label, units) == 0) {
+        return true;
+      }
+      break;
+    }
+  }
+  if (!mqttUnitsMismatchLogged) {  // Once, weewx-mqtt sends the same units in every message
+    LOG_ERROR("mqttUnitsMatch", "MQTT " << name << " is not in the WeeWX units (" << units << "), set weewx-mqtt to the same units. Skipping it.");
+    mqttUnitsMismatchLogged = true;
+  }
+  return false;
+}
+
+// Apply one weewx-mqtt observation to the network snapshot. Returns true if the display changes.
+bool applyMqttReading(const char *name, double value) {
+  size_t nameLength = strcspn(name, "_");
+  for (const mqttFieldKey &key : mqttFieldKeys) {
+    if ((strlen(key.name) == nameLength) && (strncmp(key.name, name, nameLength) == 0)) {
+      const char *suffix = (name[nameLength] == '_') ? name + nameLength + 1 : "";
+      if (!mqttUnitsMatch(key, name, suffix)) {
+        return false;
+      }
+      return setWeeWXReading(key.field, value);
+    }
+  }
+  return false;
 }
 
-// Open-Meteo Query task callback
-void tOpenMeteoUpdateCB() {
-  getOpenMeteoData();
+// Apply a weewx-mqtt observation sent as text. Values that are not numbers (None) are skipped.
+bool applyMqttText(const char *name, const char *text) {
+  char *end = NULL;
+  double value = strtod(text, &end);
+  if (end == text) {
+    return false;
+  }
+  return applyMqttReading(name, value);
 }
 
+// MQTT message callback, runs in the network task from mqttClient.loop(). weewx-mqtt publishes either one
+// JSON object with all observations or one topic per observation with the value as the payload.
+void mqttMessageCB(char *topic, byte *payload, unsigned int length) {
+  int64_t receivedTime = esp_timer_get_time();
+  bool changed = false;
+
+  mqttMessageCount += 1;
+  if ((length > 0) && (payload[0] == '{')) {
+#ifdef CYD_WWX_JSON_ARENA
+    jsonArena.reset();  // Messages are handled in the network task, between query responses
+    JsonDocument doc(&jsonArena);
+#else
+    JsonDocument doc;
+#endif  // CYD_WWX_JSON_ARENA
+    DeserializationError error = deserializeJson(doc, (const char *)payload, length);
+    if (error) {
+      LOG_ERROR("mqttMessageCB", "deserializeJson() MQTT message failed: " << error.c_str());
+      return;
+    }
+    for (JsonPairConst observation : doc.as<JsonObjectConst>()) {
+      JsonVariantConst value = observation.value();
+      if (value.is<const char *>()) {  // weewx-mqtt sends the values as strings
+        changed |= applyMqttText(observation.key().c_str(), value.as<const char *>());
+      } else if (!value.isNull()) {
+        changed |= applyMqttReading(observation.key().c_str(), value.as<double>());
+      }
+    }
+  } else {
+    char value[32] = {};
+    const char *name = strrchr(topic, '/');
+    memcpy(value, payload, min((size_t)length, sizeof(value) - 1));
+    changed = applyMqttText((name != NULL) ? name + 1 : topic, value);
+  }
+
+  LOG_DEBUG("mqttMessageCB", "MQTT message " << mqttMessageCount << " on " << topic << ", display changed: " << changed);
+  if (changed) {
+    networkSnapshotChanged = true;
+    if (networkSnapshot.updateReceivedTime == 0) {
+      networkSnapshot.updateReceivedTime = receivedTime;
+    }
+  }
+}
+#endif  // CYD_WWX_MQTT
+
 // Configuration portal timer task disable callback
 void tTimerWifiManagerDisableCB() {
   LOG_DEBUG("tTimerWifiManagerDisableCB", "Configuration portal timer disabled.");
@@ -435,21 +1000,6 @@ void tTimerWifiManagerCB() {
   }
 }
 
-// Error state timer callback
-void tTimerErrorStateCB() {
-  if (cydWeeWXErrorState == CYD_WWX_CRITICAL_ERROR) {
-    cydWeeWXErrorStateTimer += 1;
-
-    if (cydWeeWXErrorStateTimer >= CYD_WWX_ERROR_WAIT_TO_REBOOT) {
-      LOG_INFO("tTimerErrorStateCB", "Error state greater than " << CYD_WWX_ERROR_WAIT_TO_REBOOT << " seconds. Rebooting device.");
-      ESP.restart();
-    }
-  } else {
-    cydWeeWXErrorStateTimer = 0;
-    tTimerErrorState.disable();
-  }
-}
-
 // Check for Trigger Pin hold down Callback
 int cydWeeWXTriggerPinCount = 0;
 void tCydWeeWXTriggerPinCB() {
@@ -514,6 +1064,9 @@ void tProcessWifiManagerCB() {
     tTimerWifiManager.disable();
 #ifndef CYD_WWX_RUN_ON_WOKWI 
     if (WiFi.isConnected()) {
+#ifdef CYD_WWX_WIFI_FAST_CONNECT
+      saveWiFiFastConnect();  // May be a new network or access point
+#endif  // CYD_WWX_WIFI_FAST_CONNECT
       displayReInit(displayname::WEEWX_MAIN);
     } else {
       LOG_ERROR("tProcessWifiManagerCB", "WiFi not connected. Rebooting.");
@@ -561,13 +1114,13 @@ void tTimerReadLDRCB() {
       };
     case cydwwxdimmermode::SCHEDULED:
         if (cydWeeWXDimmerStartTimeInMinutes < cydWeeWXDimmerEndTimeInMinutes) {
-          if ((cydWeeWXCurrentTimeInMinutes >= cydWeeWXDimmerStartTimeInMinutes) && (cydWeeWXCurrentTimeInMinutes < cydWeeWXDimmerEndTimeInMinutes)) {
+          if ((weather->currentTimeInMinutes >= cydWeeWXDimmerStartTimeInMinutes) && (weather->currentTimeInMinutes < cydWeeWXDimmerEndTimeInMinutes)) {
             newBrightness = cydWeeWXBlMin;
           } else {
             newBrightness = cydWeeWXBlMax;
           }
         } else {
-          if ((cydWeeWXCurrentTimeInMinutes < cydWeeWXDimmerStartTimeInMinutes) && (cydWeeWXCurrentTimeInMinutes >= cydWeeWXDimmerEndTimeInMinutes)) {
+          if ((weather->currentTimeInMinutes < cydWeeWXDimmerStartTimeInMinutes) && (weather->currentTimeInMinutes >= cydWeeWXDimmerEndTimeInMinutes)) {
             newBrightness = cydWeeWXBlMax;
           } else {
             newBrightness = cydWeeWXBlMin;
@@ -576,8 +1129,8 @@ void tTimerReadLDRCB() {
         break;
     case cydwwxdimmermode::SUN_RISE_SET:
       {
-        if ((cydWeeWXCurrentTimeInMinutes < (cydWeeWXSunsetTimeInMinutes+cydWeeWXRiseSetOffset)) && 
-            (cydWeeWXCurrentTimeInMinutes > (cydWeeWXSunriseTimeInMinutes-cydWeeWXRiseSetOffset))) {
+        if ((weather->currentTimeInMinutes < (weather->sunsetTimeInMinutes+cydWeeWXRiseSetOffset)) && 
+            (weather->currentTimeInMinutes > (weather->sunriseTimeInMinutes-cydWeeWXRiseSetOffset))) {
           newBrightness = cydWeeWXBlMax;
         } else {
           newBrightness = cydWeeWXBlMin;
@@ -588,7 +1141,7 @@ void tTimerReadLDRCB() {
         break;
   }
 
-  LOG_DEBUG("tTimerReadLDRCB", "Dimmer mode: " << (unsigned int)cydWeeWXBlDimmerMode << " Current time in minutes: " << cydWeeWXCurrentTimeInMinutes << " Sunrise time in minutes: " << cydWeeWXSunriseTimeInMinutes << " Sunset time in minutes: " << cydWeeWXSunsetTimeInMinutes << " Calculated brightness: " << newBrightness);
+  LOG_DEBUG("tTimerReadLDRCB", "Dimmer mode: " << (unsigned int)cydWeeWXBlDimmerMode << " Current time in minutes: " << weather->currentTimeInMinutes << " Sunrise time in minutes: " << weather->sunriseTimeInMinutes << " Sunset time in minutes: " << weather->sunsetTimeInMinutes << " Calculated brightness: " << newBrightness);
   if (newBrightness != cydWeeWXBlCurrent) {
     cydWeeWXBlCurrent = newBrightness;
     LOG_DEBUG("tTimerReadLDRCB", "Set brightness: " << cydWeeWXBlCurrent );
@@ -626,13 +1179,14 @@ void displayCleanup( void )
 void displayReInit( displayname whichDisplay )
 {
   LOG_DEBUG("displayReInit", "Reinitializing display for display: " << (unsigned int)whichDisplay);
+  int64_t reInitStart = esp_timer_get_time();
   lv_obj_clean ( lv_scr_act() ); // Clean objects from current screen.
   lv_obj_invalidate( lv_scr_act() ); // Invalidate objects for redraw.
   lv_refr_now( cydWeeWXDisp ); // Update display immediately.
   displayCleanup(); // Cleanup screen resources.
   lv_disp_remove( cydWeeWXDisp ); // Cleanup display registration.
-  tWeeWXUpdate.disable();
-  tOpenMeteoUpdate.disable();
+  publishNetworkConfig(false, false);
+  tWeatherSnapshotPickup.disable();
   tLvglHandler.disable();
   lv_deinit(); // Cleanup LVGL resources.
   // Start LVGL
@@ -648,12 +1202,19 @@ void displayReInit( displayname whichDisplay )
   lv_display_set_rotation(cydWeeWXDisp, LV_DISPLAY_ROTATION_90);
   lv_refr_now( cydWeeWXDisp );
   if (whichDisplay == displayname::WEEWX_MAIN) {
-      tWeeWXUpdate.enable();
-      tOpenMeteoUpdate.enable();
       setCydWeeWXErrorState( CYD_WWX_NO_ERROR );
-      getWeeWXData();
-      getOpenMeteoData();
+      // Configuration may have changed so the network task starts over
+      publishNetworkConfig(true, true);
+      // Show the main display straight away with placeholders. The readings and the WMO icon are
+      // filled in by tWeatherSnapshotPickupCB as their queries finish.
+      weather = &placeholderWeather;
+      weeWXLabelsNeedRefresh = true;
+      mainDisplayFillStart = reInitStart;
       createMainWeeWXGui();
+      lv_refr_now( cydWeeWXDisp );
+      LOG_INFO("displayReInit", "Main display shown after " << (int32_t)((esp_timer_get_time() - reInitStart) / 1000) << " msec.");
+      logLvglMemory("displayReInit");
+      tWeatherSnapshotPickup.enable();
   } else if (whichDisplay == displayname::WIFI_MANAGER_MAIN) {
       setWifiMessage();
       createMainWifiManagerGui();
@@ -662,19 +1223,24 @@ void displayReInit( displayname whichDisplay )
 
 // Set Error State
 void setCydWeeWXErrorState(int state) {
+  if (state != cydWeeWXErrorState) {
+    weeWXLabelsNeedRefresh = true;  // Header text depends on the error state
+  }
   cydWeeWXErrorState = state;
+}
 
-  if (cydWeeWXErrorState == CYD_WWX_CRITICAL_ERROR) {
-    tTimerErrorState.enable();
-  } else {
-    tTimerErrorState.disable();
-    cydWeeWXErrorStateTimer = 0;
+// Set the error state and message in the network snapshot. The display picks them up with the snapshot.
+void setNetworkErrorState(int state, const String &message) {
+  bool messageChanged = setSnapshotText(networkSnapshot.errorHeaderMessage, message.c_str());
+  if ((state != networkSnapshot.errorState) || messageChanged) {
+    networkSnapshot.errorState = state;
+    networkSnapshotChanged = true;
   }
 }
 
 // Set the Sensor trend arrow direction string
 void setSensorTrend( float trend, cydwwxsensor type) {
-  String trendString = String();
+  const char *trendString = "";
   unsigned int limitIndex = (unsigned int)type;
 
   LOG_DEBUG("setSensorTrend", "Sensor <" << (int)type << "> trend: " << trend << " vs " << trendLimitsForSensors[limitIndex].lowLimit << " to " 
@@ -682,48 +1248,26 @@ void setSensorTrend( float trend, cydwwxsensor type) {
   
   if (abs(trend) >= trendLimitsForSensors[limitIndex].highLimit) {
     if (trend >= 0) {
-      trendString = String(WI_DIRECTION_UP);
+      trendString = WI_DIRECTION_UP;
       LOG_DEBUG("setSensorTrend", "UP");
     } else {
-      trendString = String(WI_DIRECTION_DOWN);
+      trendString = WI_DIRECTION_DOWN;
       LOG_DEBUG("setSensorTrend", "DOWN");
     } 
   } else if (abs(trend) >= trendLimitsForSensors[limitIndex].lowLimit) {
     if (trend >= 0) {
-      trendString = String(WI_DIRECTION_UP_RIGHT);
+      trendString = WI_DIRECTION_UP_RIGHT;
       LOG_DEBUG("setSensorTrend", "UP_RIGHT");
     } else {
-      trendString = String(WI_DIRECTION_DOWN_RIGHT);
+      trendString = WI_DIRECTION_DOWN_RIGHT;
       LOG_DEBUG("setSensorTrend", "DOWN_RIGHT");
     } 
   } else {
-    trendString = String(WI_DIRECTION_RIGHT);
+    trendString = WI_DIRECTION_RIGHT;
     LOG_DEBUG("setSensorTrend", "RIGHT");
   }
 
-  switch (type) {
-  case cydwwxsensor::TEMPERATURE:
-    trendTemperature = trendString;
-    break;
-  case cydwwxsensor::HUMIDITY:
-    trendHumidity = trendString;
-    break;
-  case cydwwxsensor::WIND:
-    trendWind = trendString;
-    break;
-  case cydwwxsensor::WIND_GUST:
-    trendWindGust = trendString;
-    break;
-  case cydwwxsensor::PRESSURE:
-    trendPressure = trendString;
-    break;
-  case cydwwxsensor::RAIN_RATE:
-    trendRainRate = trendString;
-    break;
-  default:
-    break;
-  }
-
+  setSnapshotText(networkSnapshot.reading(type).trend, trendString);
 }
 
 // Timer callback used by LVGL to get elapsed time in msec
@@ -739,81 +1283,12 @@ static void timer_cb(lv_timer_t * timer) {
   {
     case displayname::WEEWX_MAIN:
     {
-      if (isDay)
-      {
-        lv_obj_remove_style(weatherIconBox, &myNightStyle, 0);
-        lv_obj_remove_style(weatherIconBox, &myDayStyle, 0);
-        lv_obj_add_style(weatherIconBox, &myDayStyle, 0);
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelIconWMO, lv_color_hex(CYD_WWX_DAY_TEXT_COLOR), 0);
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_DAY_TEXT_COLOR), 0);
-      }
-      else
-      {
-        lv_obj_remove_style(weatherIconBox, &myNightStyle, 0);
-        lv_obj_remove_style(weatherIconBox, &myDayStyle, 0);
-        lv_obj_add_style(weatherIconBox, &myNightStyle, 0);
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelIconWMO, lv_color_hex(CYD_WWX_NIGHT_TEXT_COLOR), 0);
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_NIGHT_TEXT_COLOR), 0);
-      }
+      refreshWeatherIcon();
+      refreshWeeWXLabels();
 
-      if (cydWeeWXErrorState == CYD_WWX_CRITICAL_ERROR) {
-        // If critical then will reboot every 3 minutes, show error in header and reboot timer in weather description
-        setWmoIconAndDescription(CYD_WWX_ERROR_STATE_CODE);
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_ERROR_TEXT_COLOR), 0);
-        lv_label_set_text(textLabelWeatherDescription, String("Error state. Reboot in: " + String(CYD_WWX_ERROR_WAIT_TO_REBOOT-cydWeeWXErrorStateTimer) + " seconds.").c_str());
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelScreenHeader, lv_color_hex(CYD_WWX_ERROR_TEXT_COLOR), 0);
-        lv_label_set_text(textLabelScreenHeader, errorHeaderMessage.c_str());
-      } else if (cydWeeWXErrorState == CYD_WWX_NON_CRITICAL_ERROR) {
-        // If non-crititcal then just show error in the weather description
-        setWmoIconAndDescription(CYD_WWX_ERROR_STATE_CODE);
-        lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_ERROR_TEXT_COLOR), 0);
-        lv_label_set_text(textLabelWeatherDescription, errorHeaderMessage.c_str()); 
-        lv_label_set_text(textLabelScreenHeader, screenHeader.c_str());
-      } else {
-        setWmoIconAndDescription(weatherCode);
-        lv_label_set_text(textLabelWeatherDescription, weatherDescription.c_str());
-        lv_label_set_text(textLabelScreenHeader, screenHeader.c_str());
-      }
-      
-      lv_label_set_text(textLabelTemperature, temperature.c_str());
-      lv_label_set_text(textLabelTrendTemperature, trendTemperature.c_str());
-      lv_label_set_text(textLabelInsideTemperature, insideTemperature.c_str());
-      lv_label_set_text(textLabelUnitsTemperature, unitsTemperature.c_str());
-      lv_label_set_text(textLabelHumidity, humidity.c_str());
-      lv_label_set_text(textLabelTrendHumidity, trendHumidity.c_str());
-      lv_label_set_text(textLabelInsideHumidity, insideHumidity.c_str());
-      lv_label_set_text(textLabelUnitsHumidity, unitsHumidity.c_str());
+      // Rows 3 and 4 of the readings grid alternate
       whichReadingsToShow = !whichReadingsToShow;
-      if (whichReadingsToShow) {
-        lv_label_set_text(textLabelReadingsGrid31, iconWind.c_str());
-        lv_label_set_text(textLabelReadingsGrid32, wind.c_str());
-        lv_label_set_text(textLabelReadingsGrid33, trendWind.c_str());
-        lv_label_set_text(textLabelReadingsGrid34, unitsWind.c_str());
-        lv_label_set_text(textLabelReadingsGrid35, windDirection.c_str());
-        lv_label_set_text(textLabelReadingsGrid41, iconWindGust.c_str());
-        lv_label_set_text(textLabelReadingsGrid42, windGust.c_str());
-        lv_label_set_text(textLabelReadingsGrid43, trendWindGust.c_str());
-        lv_label_set_text(textLabelReadingsGrid44, unitsWindGust.c_str());
-        lv_label_set_text(textLabelReadingsGrid45, windGustDirection.c_str());
-      } else {
-        
-        lv_label_set_text(textLabelReadingsGrid31, iconPressure.c_str());
-        lv_label_set_text(textLabelReadingsGrid32, pressure.c_str());
-        lv_label_set_text(textLabelReadingsGrid33, trendPressure.c_str());
-        lv_label_set_text(textLabelReadingsGrid34, unitsPressure.c_str());
-        lv_label_set_text(textLabelReadingsGrid35, "");
-        lv_label_set_text(textLabelReadingsGrid41, iconRainRate.c_str());
-        lv_label_set_text(textLabelReadingsGrid42, rainRate.c_str());
-        lv_label_set_text(textLabelReadingsGrid43, trendRainRate.c_str());
-        lv_label_set_text(textLabelReadingsGrid44, unitsRainRate.c_str());
-        lv_label_set_text(textLabelReadingsGrid45, "");
-      }
-      lv_label_set_text(textLabelSunrise, sunrise.c_str());
-      lv_label_set_text(textLabelSunset, sunset.c_str());
-      lv_label_set_text(textLabelMoonrise, moonrise.c_str());
-      lv_label_set_text(textLabelMoonset, moonset.c_str());
-      lv_label_set_text(textLabelMoonPhase, moonPhase.c_str());
-      lv_label_set_text(textLabelIconMoonPhase, iconMoonPhase.c_str());
+      refreshReadingsGrid();
       break;
     }
     case displayname::WIFI_MANAGER_MAIN:
@@ -834,6 +1309,109 @@ static void timer_cb(lv_timer_t * timer) {
   }
 }
 
+// Refresh the WMO icon box: day or night colours, and the weather or the error state
+void refreshWeatherIcon() {
+  if (weather->isDay)
+  {
+    lv_obj_remove_style(weatherIconBox, &myNightStyle, 0);
+    lv_obj_remove_style(weatherIconBox, &myDayStyle, 0);
+    lv_obj_add_style(weatherIconBox, &myDayStyle, 0);
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelIconWMO, lv_color_hex(CYD_WWX_DAY_TEXT_COLOR), 0);
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_DAY_TEXT_COLOR), 0);
+  }
+  else
+  {
+    lv_obj_remove_style(weatherIconBox, &myNightStyle, 0);
+    lv_obj_remove_style(weatherIconBox, &myDayStyle, 0);
+    lv_obj_add_style(weatherIconBox, &myNightStyle, 0);
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelIconWMO, lv_color_hex(CYD_WWX_NIGHT_TEXT_COLOR), 0);
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_NIGHT_TEXT_COLOR), 0);
+  }
+
+  if (cydWeeWXErrorState == CYD_WWX_CRITICAL_ERROR) {
+    // If critical then show error in header and the next recovery step in weather description
+    setWmoIconAndDescription(CYD_WWX_ERROR_STATE_CODE);
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_ERROR_TEXT_COLOR), 0);
+    lv_label_set_text_static(textLabelWeatherDescription, getRecoveryMessage());
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelScreenHeader, lv_color_hex(CYD_WWX_ERROR_TEXT_COLOR), 0);
+    lv_label_set_text_static(textLabelScreenHeader, weather->wifiDown ? "Wi-Fi disconnected" : weather->errorHeaderMessage);
+  } else if (cydWeeWXErrorState == CYD_WWX_NON_CRITICAL_ERROR) {
+    // If non-crititcal then just show error in the weather description
+    setWmoIconAndDescription(CYD_WWX_ERROR_STATE_CODE);
+    lv_obj_set_style_text_color((lv_obj_t*) textLabelWeatherDescription, lv_color_hex(CYD_WWX_ERROR_TEXT_COLOR), 0);
+    lv_label_set_text_static(textLabelWeatherDescription, weather->errorHeaderMessage); 
+  } else {
+    setWmoIconAndDescription(weather->weatherCode);
+    lv_label_set_text_static(textLabelWeatherDescription, weatherDescription);
+  }
+}
+
+// Log the memory LVGL has allocated and the most it has had at once. With LVGL's own allocator that is
+// its LV_MEM_SIZE pool. lv_conf.h has LVGL allocate from the C library heap instead, so then the free
+// heap and its low-water mark are logged.
+void logLvglMemory(const char *svc) {
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+  lv_mem_monitor_t monitor;
+  lv_mem_monitor(&monitor);
+  LOG_INFO(svc, "LVGL memory used: " << (uint32_t)(monitor.total_size - monitor.free_size) << " of " << (uint32_t)monitor.total_size
+    << " bytes, high-water mark: " << (uint32_t)monitor.max_used << " bytes, fragmentation: " << monitor.frag_pct << "%.");
+#else
+  LOG_INFO(svc, "LVGL memory is on the heap. Free heap: " << ESP.getFreeHeap() << " bytes, lowest: " << ESP.getMinFreeHeap() << " bytes.");
+#endif  // LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+}
+
+// Only refresh the fixed WeeWX labels when new readings arrived
+void refreshWeeWXLabels() {
+  if (weeWXLabelsNeedRefresh) {
+    if (cydWeeWXErrorState != CYD_WWX_CRITICAL_ERROR) {  // The header shows the error when critical
+      lv_label_set_text_static(textLabelScreenHeader, weather->screenHeader);
+    }
+    lv_label_set_text_static(textLabelTemperature, weather->reading(cydwwxsensor::TEMPERATURE).value);
+    lv_label_set_text_static(textLabelTrendTemperature, weather->reading(cydwwxsensor::TEMPERATURE).trend);
+    lv_label_set_text_static(textLabelInsideTemperature, weather->insideTemperature);
+    lv_label_set_text_static(textLabelUnitsTemperature, weather->reading(cydwwxsensor::TEMPERATURE).units);
+    lv_label_set_text_static(textLabelHumidity, weather->reading(cydwwxsensor::HUMIDITY).value);
+    lv_label_set_text_static(textLabelTrendHumidity, weather->reading(cydwwxsensor::HUMIDITY).trend);
+    lv_label_set_text_static(textLabelInsideHumidity, weather->insideHumidity);
+    lv_label_set_text_static(textLabelUnitsHumidity, weather->reading(cydwwxsensor::HUMIDITY).units);
+    lv_label_set_text_static(textLabelSunrise, weather->sunrise);
+    lv_label_set_text_static(textLabelSunset, weather->sunset);
+    lv_label_set_text_static(textLabelMoonrise, weather->moonrise);
+    lv_label_set_text_static(textLabelMoonset, weather->moonset);
+    lv_label_set_text_static(textLabelMoonPhase, weather->moonPhase);
+    lv_label_set_text_static(textLabelIconMoonPhase, weather->iconMoonPhase);
+    weeWXLabelsNeedRefresh = false;
+  }
+}
+
+// Refresh the row 3 and 4 readings currently shown in the readings grid
+void refreshReadingsGrid() {
+  if (whichReadingsToShow) {
+    lv_label_set_text_static(textLabelReadingsGrid31, iconWind);
+    lv_label_set_text_static(textLabelReadingsGrid32, weather->reading(cydwwxsensor::WIND).value);
+    lv_label_set_text_static(textLabelReadingsGrid33, weather->reading(cydwwxsensor::WIND).trend);
+    lv_label_set_text_static(textLabelReadingsGrid34, weather->reading(cydwwxsensor::WIND).units);
+    lv_label_set_text_static(textLabelReadingsGrid35, weather->windDirection);
+    lv_label_set_text_static(textLabelReadingsGrid41, iconWindGust);
+    lv_label_set_text_static(textLabelReadingsGrid42, weather->reading(cydwwxsensor::WIND_GUST).value);
+    lv_label_set_text_static(textLabelReadingsGrid43, weather->reading(cydwwxsensor::WIND_GUST).trend);
+    lv_label_set_text_static(textLabelReadingsGrid44, weather->reading(cydwwxsensor::WIND_GUST).units);
+    lv_label_set_text_static(textLabelReadingsGrid45, weather->windDirection);
+  } else {
+    
+    lv_label_set_text_static(textLabelReadingsGrid31, iconPressure);
+    lv_label_set_text_static(textLabelReadingsGrid32, weather->reading(cydwwxsensor::PRESSURE).value);
+    lv_label_set_text_static(textLabelReadingsGrid33, weather->reading(cydwwxsensor::PRESSURE).trend);
+    lv_label_set_text_static(textLabelReadingsGrid34, weather->reading(cydwwxsensor::PRESSURE).units);
+    lv_label_set_text_static(textLabelReadingsGrid35, "");
+    lv_label_set_text_static(textLabelReadingsGrid41, iconRainRate);
+    lv_label_set_text_static(textLabelReadingsGrid42, weather->reading(cydwwxsensor::RAIN_RATE).value);
+    lv_label_set_text_static(textLabelReadingsGrid43, weather->reading(cydwwxsensor::RAIN_RATE).trend);
+    lv_label_set_text_static(textLabelReadingsGrid44, weather->reading(cydwwxsensor::RAIN_RATE).units);
+    lv_label_set_text_static(textLabelReadingsGrid45, "");
+  }
+}
+
 // Create cydWeeWX GUI when booting
 void createBootGui(void) {
   String bootMessage = String(programName) + String(" v") + String(programVersion) + String("\n\nBooting... Please wait.");
@@ -944,11 +1522,11 @@ void createMainWeeWXGui(void) {
   lv_obj_align(textLabelIconWMO, LV_ALIGN_CENTER, 0, -5);
   lv_obj_set_style_text_align(textLabelIconWMO, LV_TEXT_ALIGN_CENTER, 0);
   
-  setWmoIconAndDescription(weatherCode);
+  setWmoIconAndDescription(weather->weatherCode);
   
   // Weather Description
   textLabelWeatherDescription = lv_label_create(lv_screen_active());
-  lv_label_set_text(textLabelWeatherDescription, weatherDescription.c_str());
+  lv_label_set_text_static(textLabelWeatherDescription, weatherDescription);
   lv_obj_set_parent(textLabelWeatherDescription, weatherIconBox);
   lv_obj_align(textLabelWeatherDescription, LV_ALIGN_BOTTOM_MID, 0, 10);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelWeatherDescription, &lv_font_montserrat_16, 0);
@@ -958,7 +1536,7 @@ void createMainWeeWXGui(void) {
 
   // Screen header
   textLabelScreenHeader = lv_label_create(lv_screen_active());
-  lv_label_set_text(textLabelScreenHeader, screenHeader.c_str());
+  lv_label_set_text_static(textLabelScreenHeader, weather->screenHeader);
   lv_obj_align(textLabelScreenHeader, LV_ALIGN_CENTER, 0, -105);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelScreenHeader, &lv_font_montserrat_22, 0);
   lv_label_set_long_mode(textLabelScreenHeader, LV_LABEL_LONG_SCROLL_CIRCULAR);
@@ -978,137 +1556,137 @@ void createMainWeeWXGui(void) {
   lv_obj_set_grid_cell(textLabelIconOutside, LV_GRID_ALIGN_CENTER, 1, 2, LV_GRID_ALIGN_CENTER, 0, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconOutside, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelIconOutside, &cellStyle, 0);
-  lv_label_set_text(textLabelIconOutside, String(LV_SYMBOL_IMAGE).c_str());
+  lv_label_set_text_static(textLabelIconOutside, LV_SYMBOL_IMAGE);
 
   textLabelIconInside = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconInside, LV_GRID_ALIGN_CENTER, 3, 2, LV_GRID_ALIGN_CENTER, 0, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconInside, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelIconInside, &cellStyle, 0);
-  lv_label_set_text(textLabelIconInside, String(LV_SYMBOL_HOME).c_str());
+  lv_label_set_text_static(textLabelIconInside, LV_SYMBOL_HOME);
 
   // Temperature Outside then Inside
   textLabelIconTemperature = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconTemperature, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconTemperature, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconTemperature, &cellStyle, 0);
-  lv_label_set_text(textLabelIconTemperature, iconTemperature.c_str());
+  lv_label_set_text_static(textLabelIconTemperature, iconTemperature);
 
   textLabelTemperature = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelTemperature, LV_GRID_ALIGN_END, 1, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelTemperature, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelTemperature, &cellStyle, 0);
-  lv_label_set_text(textLabelTemperature, temperature.c_str());
+  lv_label_set_text_static(textLabelTemperature, weather->reading(cydwwxsensor::TEMPERATURE).value);
 
   textLabelTrendTemperature = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelTrendTemperature, LV_GRID_ALIGN_START, 2, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelTrendTemperature, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelTrendTemperature, &cellStyle, 0);
-  lv_label_set_text(textLabelTrendTemperature, trendTemperature.c_str());
+  lv_label_set_text_static(textLabelTrendTemperature, weather->reading(cydwwxsensor::TEMPERATURE).trend);
 
   textLabelInsideTemperature = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelInsideTemperature, LV_GRID_ALIGN_END, 3, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelInsideTemperature, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelInsideTemperature, &cellStyle, 0);
-  lv_label_set_text(textLabelInsideTemperature, insideTemperature.c_str());
+  lv_label_set_text_static(textLabelInsideTemperature, weather->insideTemperature);
 
   textLabelUnitsTemperature = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelUnitsTemperature, LV_GRID_ALIGN_START, 4, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelUnitsTemperature, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelUnitsTemperature, &cellStyle, 0);
-  lv_label_set_text(textLabelUnitsTemperature, unitsTemperature.c_str());
+  lv_label_set_text_static(textLabelUnitsTemperature, weather->reading(cydwwxsensor::TEMPERATURE).units);
 
   // Humidity Outside then Inside
   textLabelIconHumidity = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconHumidity, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconHumidity, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconHumidity, &cellStyle, 0);
-  lv_label_set_text(textLabelIconHumidity, iconHumidity.c_str());
+  lv_label_set_text_static(textLabelIconHumidity, iconHumidity);
   
   textLabelHumidity = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelHumidity, LV_GRID_ALIGN_END, 1, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelHumidity, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelHumidity, &cellStyle, 0);
-  lv_label_set_text(textLabelHumidity, humidity.c_str());
+  lv_label_set_text_static(textLabelHumidity, weather->reading(cydwwxsensor::HUMIDITY).value);
 
   textLabelTrendHumidity = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelTrendHumidity, LV_GRID_ALIGN_START, 2, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelTrendHumidity, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelTrendHumidity, &cellStyle, 0);
-  lv_label_set_text(textLabelTrendHumidity, trendHumidity.c_str());
+  lv_label_set_text_static(textLabelTrendHumidity, weather->reading(cydwwxsensor::HUMIDITY).trend);
 
   textLabelInsideHumidity = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelInsideHumidity, LV_GRID_ALIGN_END, 3, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelInsideHumidity, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelInsideHumidity, &cellStyle, 0);
-  lv_label_set_text(textLabelInsideHumidity, insideHumidity.c_str());
+  lv_label_set_text_static(textLabelInsideHumidity, weather->insideHumidity);
   
   textLabelUnitsHumidity = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelUnitsHumidity, LV_GRID_ALIGN_START, 4, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelUnitsHumidity, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelUnitsHumidity, &cellStyle, 0);
-  lv_label_set_text(textLabelUnitsHumidity, unitsHumidity.c_str());
+  lv_label_set_text_static(textLabelUnitsHumidity, weather->reading(cydwwxsensor::HUMIDITY).units);
 
   // Sensor readings grid row 3 start with  Wind 
   textLabelReadingsGrid31 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid31, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 3, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid31, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelReadingsGrid31, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid31, iconWind.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid31, iconWind);
   
   textLabelReadingsGrid32 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid32, LV_GRID_ALIGN_END, 1, 1, LV_GRID_ALIGN_CENTER, 3, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid32, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelReadingsGrid32, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid32, wind.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid32, weather->reading(cydwwxsensor::WIND).value);
 
   textLabelReadingsGrid33 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid33, LV_GRID_ALIGN_START, 2, 1, LV_GRID_ALIGN_CENTER, 3, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid33, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelReadingsGrid33, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid33, trendWind.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid33, weather->reading(cydwwxsensor::WIND).trend);
   
   textLabelReadingsGrid34 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid34, LV_GRID_ALIGN_START, 3, 1, LV_GRID_ALIGN_CENTER, 3, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid34, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelReadingsGrid34, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid34, unitsWind.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid34, weather->reading(cydwwxsensor::WIND).units);
 
   textLabelReadingsGrid35 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid35, LV_GRID_ALIGN_CENTER, 4, 1, LV_GRID_ALIGN_CENTER, 3, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid35, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelReadingsGrid35, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid35, windDirection.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid35, weather->windDirection);
   
   // Sensor readings grid row 4 start with Wind Gust
   textLabelReadingsGrid41 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid41, LV_GRID_ALIGN_START, 0, 1, LV_GRID_ALIGN_CENTER, 4, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid41, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelReadingsGrid41, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid41, iconWindGust.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid41, iconWindGust);
   
   textLabelReadingsGrid42 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid42, LV_GRID_ALIGN_END, 1, 1, LV_GRID_ALIGN_CENTER, 4, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid42, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelReadingsGrid42, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid42, windGust.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid42, weather->reading(cydwwxsensor::WIND_GUST).value);
 
   textLabelReadingsGrid43 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid43, LV_GRID_ALIGN_START, 2, 1, LV_GRID_ALIGN_CENTER, 4, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid43, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelReadingsGrid43, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid43, trendWindGust.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid43, weather->reading(cydwwxsensor::WIND_GUST).trend);
   
   textLabelReadingsGrid44 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid44, LV_GRID_ALIGN_START, 3, 1, LV_GRID_ALIGN_CENTER, 4, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid44, &lv_font_montserrat_22, 0);
   lv_obj_add_style(textLabelReadingsGrid44, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid44, unitsWindGust.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid44, weather->reading(cydwwxsensor::WIND_GUST).units);
 
   textLabelReadingsGrid45 = lv_label_create(sensorReadingsGrid);
   lv_obj_set_grid_cell(textLabelReadingsGrid45, LV_GRID_ALIGN_CENTER, 4, 1, LV_GRID_ALIGN_CENTER, 4, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelReadingsGrid45, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelReadingsGrid45, &cellStyle, 0);
-  lv_label_set_text(textLabelReadingsGrid45, windGustDirection.c_str());
+  lv_label_set_text_static(textLabelReadingsGrid45, weather->windDirection);
   
   // Almanac readings grid
   almanacReadingsGrid = lv_obj_create(lv_screen_active());
@@ -1122,65 +1700,65 @@ void createMainWeeWXGui(void) {
   lv_obj_set_grid_cell(textLabelIconSunrise, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 0, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconSunrise, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconSunrise, &cellStyle, 0);
-  lv_label_set_text(textLabelIconSunrise, String(WI_SUNRISE).c_str());
+  lv_label_set_text_static(textLabelIconSunrise, WI_SUNRISE);
   
   textLabelSunrise = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelSunrise, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 0, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelSunrise, &dejaVuSansCondensed_18c, 0);
   lv_obj_add_style(textLabelSunrise, &cellStyle, 0);
-  lv_label_set_text(textLabelSunrise, sunrise.c_str());
+  lv_label_set_text_static(textLabelSunrise, weather->sunrise);
   
   // Sunset
   textLabelIconSunset = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconSunset, LV_GRID_ALIGN_CENTER, 2, 1, LV_GRID_ALIGN_CENTER, 0, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconSunset, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconSunset, &cellStyle, 0);
-  lv_label_set_text(textLabelIconSunset, String(WI_SUNSET).c_str());
+  lv_label_set_text_static(textLabelIconSunset, WI_SUNSET);
     
   textLabelSunset = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelSunset, LV_GRID_ALIGN_START, 3, 1, LV_GRID_ALIGN_CENTER, 0, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelSunset, &dejaVuSansCondensed_18c, 0);
   lv_obj_add_style(textLabelSunset, &cellStyle, 0);
-  lv_label_set_text(textLabelSunset, sunset.c_str());
+  lv_label_set_text_static(textLabelSunset, weather->sunset);
   
   // Moonrise
   textLabelIconMoonrise = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconMoonrise, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconMoonrise, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconMoonrise, &cellStyle, 0);
-  lv_label_set_text(textLabelIconMoonrise, String(WI_MOONRISE).c_str());
+  lv_label_set_text_static(textLabelIconMoonrise, WI_MOONRISE);
   
   textLabelMoonrise = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelMoonrise, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelMoonrise, &dejaVuSansCondensed_18c, 0);
   lv_obj_add_style(textLabelMoonrise, &cellStyle, 0);
-  lv_label_set_text(textLabelMoonrise, moonrise.c_str());
+  lv_label_set_text_static(textLabelMoonrise, weather->moonrise);
  
   // Moonset
   textLabelIconMoonset = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconMoonset, LV_GRID_ALIGN_CENTER, 2, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconMoonset, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconMoonset, &cellStyle, 0);
-  lv_label_set_text(textLabelIconMoonset, String(WI_MOONSET).c_str());
+  lv_label_set_text_static(textLabelIconMoonset, WI_MOONSET);
   
   textLabelMoonset = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelMoonset, LV_GRID_ALIGN_START, 3, 1, LV_GRID_ALIGN_CENTER, 1, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelMoonset, &dejaVuSansCondensed_18c, 0);
   lv_obj_add_style(textLabelMoonset, &cellStyle, 0);
-  lv_label_set_text(textLabelMoonset, moonset.c_str());
+  lv_label_set_text_static(textLabelMoonset, weather->moonset);
   
   // Moon Phase
   textLabelIconMoonPhase = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelIconMoonPhase, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelIconMoonPhase, &weatherIcons_22c, 0);
   lv_obj_add_style(textLabelIconMoonPhase, &cellStyle, 0);
-  lv_label_set_text(textLabelIconMoonPhase, iconMoonPhase.c_str());
+  lv_label_set_text_static(textLabelIconMoonPhase, weather->iconMoonPhase);
   
   textLabelMoonPhase = lv_label_create(almanacReadingsGrid);
   lv_obj_set_grid_cell(textLabelMoonPhase, LV_GRID_ALIGN_START, 1, 3, LV_GRID_ALIGN_CENTER, 2, 1);
   lv_obj_set_style_text_font((lv_obj_t*) textLabelMoonPhase, &lv_font_montserrat_16, 0);
   lv_obj_add_style(textLabelMoonPhase, &cellStyle, 0);
-  lv_label_set_text(textLabelMoonPhase, moonPhase.c_str());
+  lv_label_set_text_static(textLabelMoonPhase, weather->moonPhase);
 
   lv_timer_t * timer = lv_timer_create(timer_cb, CYD_WWX_WEEWX_LV_TIMER, NULL);
   lv_timer_ready(timer);
@@ -1208,237 +1786,242 @@ void setWmoIconAndDescription(int code) {
   switch (code) {
     
     case 0:
-      if(isDay) 
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SUNNY).c_str());
+      if(weather->isDay) 
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SUNNY);
       else 
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_CLEAR).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_CLEAR);
       weatherDescription = "CLEAR SKY";
       break;
     case 1: 
-      if(isDay) 
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SUNNY_OVERCAST).c_str());
+      if(weather->isDay) 
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SUNNY_OVERCAST);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_PARTLY_CLOUDY).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_PARTLY_CLOUDY);
       weatherDescription = "MAINLY CLEAR";
       break;
     case 2: 
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_CLOUDY).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_CLOUDY);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_CLOUDY).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_CLOUDY);
       weatherDescription = "PARTLY CLOUDY";
       break;
     case 3:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_CLOUDY).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_CLOUDY);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_CLOUDY).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_CLOUDY);
       weatherDescription = "OVERCAST";
       break;
     case 45:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_FOG).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_FOG);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_FOG).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_FOG);
       weatherDescription = "FOG";
       break;
     case 48:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_FOG).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_FOG);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_FOG).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_FOG);
       weatherDescription = "DEPOSITING RIME FOG";
       break;
     case 51:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SPRINKLE).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SPRINKLE);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SPRINKLE).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SPRINKLE);
       weatherDescription = "DRIZZLE LIGHT INTENSITY";
       break;
     case 53:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_RAIN).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_RAIN);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_RAIN).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_RAIN);
       weatherDescription = "DRIZZLE MODERATE INTENSITY";
       break;
     case 55:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SHOWERS).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SHOWERS);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SHOWERS).c_str()); 
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SHOWERS); 
       weatherDescription = "DRIZZLE DENSE INTENSITY";
       break;
     case 56:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_RAIN_MIX).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_RAIN_MIX);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_RAIN_MIX).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_RAIN_MIX);
       weatherDescription = "FREEZING DRIZZLE LIGHT";
       break;
     case 57:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SLEET).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SLEET);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SLEET).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SLEET);
       weatherDescription = "FREEZING DRIZZLE DENSE";
       break;
     case 61:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SPRINKLE).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SPRINKLE);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SPRINKLE).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SPRINKLE);
       weatherDescription = "RAIN SLIGHT INTENSITY";
       break;
     case 63:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_RAIN).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_RAIN);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_RAIN).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_RAIN);
       weatherDescription = "RAIN MODERATE INTENSITY";
       break;
     case 65:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_STORM_SHOWERS).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_STORM_SHOWERS);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_STORM_SHOWERS).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_STORM_SHOWERS);
       weatherDescription = "RAIN HEAVY INTENSITY";
       break;
     case 66:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SLEET).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SLEET);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SLEET).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SLEET);
       weatherDescription = "FREEZING RAIN LIGHT INTENSITY";
       break;
     case 67:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SLEET_STORM).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SLEET_STORM);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SLEET_STORM).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SLEET_STORM);
       weatherDescription = "FREEZING RAIN HEAVY INTENSITY";
       break;
     case 71:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SNOW).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SNOW);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SNOW).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SNOW);
       weatherDescription = "SNOW FALL SLIGHT INTENSITY";
       break;
     case 73:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SNOW).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SNOW);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SNOW).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SNOW);
       weatherDescription = "SNOW FALL MODERATE INTENSITY";
       break;
     case 75:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SNOW_WIND).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SNOW_WIND);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SNOW_WIND).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SNOW_WIND);
       weatherDescription = "SNOW FALL HEAVY INTENSITY";
       break;
     case 77:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SNOW).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SNOW);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SNOW).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SNOW);
       weatherDescription = "SNOW GRAINS";
       break;
     case 80:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_RAIN).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_RAIN);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_RAIN).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_RAIN);
       weatherDescription = "RAIN SHOWERS SLIGHT";
       break;
     case 81:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_RAIN).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_RAIN);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_RAIN).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_RAIN);
       weatherDescription = "RAIN SHOWERS MODERATE";
       break;
     case 82:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_STORM_SHOWERS).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_STORM_SHOWERS);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_STORM_SHOWERS).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_STORM_SHOWERS);
       weatherDescription = "RAIN SHOWERS VIOLENT";
       break;
     case 85:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SNOW).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SNOW);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SNOW).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SNOW);
       weatherDescription = "SNOW SHOWERS SLIGHT";
       break;
     case 86:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_SNOW).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_SNOW);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_SNOW).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_SNOW);
       weatherDescription = "SNOW SHOWERS HEAVY";
       break;
     case 95:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_THUNDERSTORM).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_THUNDERSTORM);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_THUNDERSTORM).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_THUNDERSTORM);
       weatherDescription = "THUNDERSTORM";
       break;
     case 96:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_HAIL).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_HAIL);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_HAIL).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_HAIL);
       weatherDescription = "THUNDERSTORM SLIGHT HAIL";
       break;
     case 99:
-      if (isDay)
-        lv_label_set_text(textLabelIconWMO, String(WI_DAY_HAIL).c_str());
+      if (weather->isDay)
+        lv_label_set_text_static(textLabelIconWMO, WI_DAY_HAIL);
       else
-        lv_label_set_text(textLabelIconWMO, String(WI_NIGHT_HAIL).c_str());
+        lv_label_set_text_static(textLabelIconWMO, WI_NIGHT_HAIL);
       weatherDescription = "THUNDERSTORM HEAVY HAIL";
       break;
     case CYD_WWX_ERROR_STATE_CODE: 
-      lv_label_set_text(textLabelIconWMO, String(WI_ERROR).c_str());
-      weatherDescription = String("cydWeeWX in Error State");
+      lv_label_set_text_static(textLabelIconWMO, WI_ERROR);
+      weatherDescription = "cydWeeWX in Error State";
+      break;
+    case CYD_WWX_LOADING_STATE_CODE: 
+      lv_label_set_text_static(textLabelIconWMO, WI_NA);
+      weatherDescription = "WAITING FOR DATA";
       break;
     default: 
-      lv_label_set_text(textLabelIconWMO, String(WI_NA).c_str());
-      weatherDescription = String("WMO CODE <" + String(code) + "> NOT FOUND");
+      lv_label_set_text_static(textLabelIconWMO, WI_NA);
+      snprintf(weatherCodeNotFound, sizeof(weatherCodeNotFound), "WMO CODE <%d> NOT FOUND", code);
+      weatherDescription = weatherCodeNotFound;
       break;
   }
 }
 
 // Return weather direction error based on direction in degrees
-String getWindDirectionString(double direction)
+const char *getWindDirectionString(double direction)
 {
-  String directionString = String();
+  const char *directionString = "";
 
   if (direction == 0 )
-    directionString = String();
+    directionString = "";
   else if ((direction > (360-22.5)) || (direction <= 22.5))
-    directionString = String( WI_WIND_DIRECTION_360 );
+    directionString = WI_WIND_DIRECTION_360;
   else if ((direction > 22.5) && (direction <= (45+22.5)))
-    directionString = String( WI_WIND_DIRECTION_45 );
+    directionString = WI_WIND_DIRECTION_45;
   else if ((direction > (45+22.5)) && (direction <= (90+22.5)))
-    directionString = String( WI_WIND_DIRECTION_90 );
+    directionString = WI_WIND_DIRECTION_90;
   else if ((direction > (90+22.5)) && (direction <= (135+22.5)))
-    directionString = String( WI_WIND_DIRECTION_135 );
+    directionString = WI_WIND_DIRECTION_135;
   else if ((direction > (135+22.5)) && (direction <= (180+22.5)))
-    directionString = String( WI_WIND_DIRECTION_180 );
+    directionString = WI_WIND_DIRECTION_180;
   else if ((direction > (180+22.5)) && (direction <= (225+22.5)))
-    directionString = String( WI_WIND_DIRECTION_225 );
+    directionString = WI_WIND_DIRECTION_225;
   else if ((direction > (225+22.5)) && (direction <= (270+22.5)))
-    directionString = String( WI_WIND_DIRECTION_270 );
+    directionString = WI_WIND_DIRECTION_270;
   else if ((direction > (270+22.5)) && (direction <= (315+22.5)))
-    directionString = String( WI_WIND_DIRECTION_315 );
+    directionString = WI_WIND_DIRECTION_315;
   else
-    directionString = String();
+    directionString = "";
 
   LOG_DEBUG("getWindDirectionString", "Windirection: " << direction << " Symbol: " << directionString);
   return directionString;
@@ -1447,117 +2030,123 @@ String getWindDirectionString(double direction)
 // Set the moon phase icon and description based on phase % and whether or not waxing
 void setMoonPhaseString(int phasePercent, bool isWaxing)
 {
+  const char *icon;
+  const char *phase;
+
   if (phasePercent > 95) {
-    iconMoonPhase = String(WI_MOON_FULL);
-    moonPhase = String("Full Moon at " + String(phasePercent) + "%");
+    icon = WI_MOON_FULL;
+    phase = "Full Moon";
   } else if (phasePercent > 88) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_GIBBOUS_6);
-      moonPhase = String("Waxing Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_GIBBOUS_6;
+      phase = "Waxing Gibbous";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_GIBBOUS_1);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_GIBBOUS_1;
+      phase = "Waning Gibbous";
     }
   } else if (phasePercent > 81) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_GIBBOUS_5);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_GIBBOUS_5;
+      phase = "Waning Gibbous";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_GIBBOUS_2);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_GIBBOUS_2;
+      phase = "Waning Gibbous";
     }
   } else if (phasePercent > 74) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_GIBBOUS_4);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_GIBBOUS_4;
+      phase = "Waning Gibbous";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_GIBBOUS_3);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_GIBBOUS_3;
+      phase = "Waning Gibbous";
     }
   } else if (phasePercent > 67) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_GIBBOUS_3);
-      moonPhase = String("Waxing Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_GIBBOUS_3;
+      phase = "Waxing Gibbous";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_GIBBOUS_4);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_GIBBOUS_4;
+      phase = "Waning Gibbous";
     }
   } else if (phasePercent > 60) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_GIBBOUS_2);
-      moonPhase = String("Waxing Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_GIBBOUS_2;
+      phase = "Waxing Gibbous";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_GIBBOUS_5);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_GIBBOUS_5;
+      phase = "Waning Gibbous";
     }
   } else if (phasePercent > 53) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_GIBBOUS_1);
-      moonPhase = String("Waxing Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_GIBBOUS_1;
+      phase = "Waxing Gibbous";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_GIBBOUS_6);
-      moonPhase = String("Waning Gibbous at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_GIBBOUS_6;
+      phase = "Waning Gibbous";
     }
   } else if (phasePercent > 46) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_FIRST_QUARTER);
-      moonPhase = String("First Quarter at " + String(phasePercent) + "%");
+      icon = WI_MOON_FIRST_QUARTER;
+      phase = "First Quarter";
     } else {
-      iconMoonPhase = String(WI_MOON_THIRD_QUARTER);
-      moonPhase = String("Third Quarter at " + String(phasePercent) + "%");
+      icon = WI_MOON_THIRD_QUARTER;
+      phase = "Third Quarter";
     }
   } else if (phasePercent > 39) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_CRESCENT_6);
-      moonPhase = String("Waxing Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_CRESCENT_6;
+      phase = "Waxing Crescent";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_CRESCENT_1);
-      moonPhase = String("Waning Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_CRESCENT_1;
+      phase = "Waning Crescent";
     }
   } else if (phasePercent > 32) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_CRESCENT_5);
-      moonPhase = String("Waxing Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_CRESCENT_5;
+      phase = "Waxing Crescent";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_CRESCENT_2);
-      moonPhase = String("Waning Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_CRESCENT_2;
+      phase = "Waning Crescent";
     }
   } else if (phasePercent > 25) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_CRESCENT_4);
-      moonPhase = String("Waxing Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_CRESCENT_4;
+      phase = "Waxing Crescent";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_CRESCENT_3);
-      moonPhase = String("Waning Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_CRESCENT_3;
+      phase = "Waning Crescent";
     }
   } else if (phasePercent > 18) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_CRESCENT_3);
-      moonPhase = String("Waxing Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_CRESCENT_3;
+      phase = "Waxing Crescent";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_CRESCENT_4);
-      moonPhase = String("Waning Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_CRESCENT_4;
+      phase = "Waning Crescent";
     }
   } else if (phasePercent > 11) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_CRESCENT_2);
-      moonPhase = String("Waxing Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_CRESCENT_2;
+      phase = "Waxing Crescent";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_CRESCENT_5);
-      moonPhase = String("Waning Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_CRESCENT_5;
+      phase = "Waning Crescent";
     }
   } else if (phasePercent > 4) {
     if (isWaxing) {
-      iconMoonPhase = String(WI_MOON_WAXING_CRESCENT_1);
-      moonPhase = String("Waxing Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WAXING_CRESCENT_1;
+      phase = "Waxing Crescent";
     } else {
-      iconMoonPhase = String(WI_MOON_WANING_CRESCENT_6);
-      moonPhase = String("Waning Crescent at " + String(phasePercent) + "%");
+      icon = WI_MOON_WANING_CRESCENT_6;
+      phase = "Waning Crescent";
     }
   } else {
-    iconMoonPhase = String(WI_MOON_NEW);
-    moonPhase = String("New Moon at " + String(phasePercent) + "%");
+    icon = WI_MOON_NEW;
+    phase = "New Moon";
   }
+
+  setSnapshotText(networkSnapshot.iconMoonPhase, icon);
+  snprintf(networkSnapshot.moonPhase, sizeof(networkSnapshot.moonPhase), "%s at %d%%", phase, phasePercent);
 }
 
 // set & update the messages displayed while in Configuration Portal Mode
@@ -1582,262 +2171,786 @@ void setWifiMessage() {
   }
 }
 
-// Do Open-Meteo query to get WMO weather code 
+// Start an Open-Meteo query to get WMO weather code. The response is handled by processOpenMeteoResponse().
 void getOpenMeteoData() {
-  if (cydWeeWXErrorState == CYD_WWX_CRITICAL_ERROR) {
+  if (networkSnapshot.errorState == CYD_WWX_CRITICAL_ERROR) {
     LOG_INFO("getOpenMeteoData", "In error state, skipping GET processing.");
     return;
   }
 
   if (WiFi.status() == WL_CONNECTED) {
-    HTTPClient http;
+    if (openMeteoFetch.isBusy()) {
+      LOG_INFO("getOpenMeteoData", "Previous Open-Meteo query still in progress, skipping.");
+      return;
+    }
     // Construct the API endpoint
     char urlBuf[256] = {};
     
-    if (!((latitude.isEmpty()) || (longitude.isEmpty()))) {
-      sprintf(urlBuf, CYD_WWX_OPEN_METEO_URL, latitude, longitude);
-      http.begin(String(urlBuf));
-      int httpCode = http.GET(); // Make the GET request
-
-      if (httpCode > 0) {
-        String om_payload = http.getString();
-
-        LOG_DEBUG("getOpenMeteoData","Request information:");
-        LOG_DEBUG("getOpenMeteoData", om_payload);
-
-        // Parse the JSON to extract the time
-        JsonDocument om_doc;
-        DeserializationError error = deserializeJson(om_doc, om_payload);
-        if (!error) 
-        {
-          weatherCode = om_doc["current"]["weather_code"];
-          setCydWeeWXErrorState(CYD_WWX_NO_ERROR);
-        } else {
-          LOG_ERROR("getOpenMeteoData", "deserializeJson() OpenMeteo Response failed: " << error.c_str());
-          setCydWeeWXErrorState( CYD_WWX_NON_CRITICAL_ERROR );
-          errorHeaderMessage = String("Deserialization error, cannot retrieve WMO icon.");
-        }
-      } else {
-        LOG_ERROR("getOpenMeteoData", "GET request failed, error: " << http.errorToString(httpCode).c_str());
-        setCydWeeWXErrorState(CYD_WWX_NON_CRITICAL_ERROR);
-        errorHeaderMessage = String("Open-Meteo GET request failed, error: " + http.errorToString(httpCode));
+    if (!((stationLatitude.isEmpty()) || (stationLongitude.isEmpty()))) {
+      snprintf(urlBuf, sizeof(urlBuf), CYD_WWX_OPEN_METEO_URL, stationLatitude.c_str(), stationLongitude.c_str(),
+        CYD_WWX_OPEN_METEO_FORECAST_HOURS);
+      if (!openMeteoFetch.begin(urlBuf, "", false)) {
+        processOpenMeteoResponse();
       }
-
-      http.end(); // Close connection
     } else {
       LOG_ERROR("getOpenMeteoData", "Latitude or longitude is blank, cannot retrieve WMO icon.");
-      setCydWeeWXErrorState(CYD_WWX_NON_CRITICAL_ERROR);
-      errorHeaderMessage = String("Latitude or longitude is blank, cannot retrieve WMO icon.");
+      setNetworkErrorState(CYD_WWX_NON_CRITICAL_ERROR, String("Latitude or longitude is blank, cannot retrieve WMO icon."));
+      openMeteoFailed = true;
+      updateWeatherCode();
     }
   } else {
     LOG_ERROR("getOpenMeteoData", "Not connected to Wi-Fi");
-    setCydWeeWXErrorState(CYD_WWX_CRITICAL_ERROR);
-    errorHeaderMessage = String("Not connected to Wi-Fi");
+    setNetworkErrorState(CYD_WWX_CRITICAL_ERROR, String("Not connected to Wi-Fi"));
 
   }
 }
 
-// Do WeeWX server query to update current weather data
-void getWeeWXData() {
-  if (cydWeeWXErrorState == CYD_WWX_CRITICAL_ERROR) {
-    LOG_INFO("getWeeWXData", "In error state, skipping GET processing.");
+// Handle a finished Open-Meteo query
+void processOpenMeteoResponse() {
+  LOG_INFO("processOpenMeteoResponse", "Open-Meteo query took " << openMeteoFetch.elapsed() << " msec in " << openMeteoFetch.stepCount
+    << " steps, longest step: " << openMeteoFetch.maxStepTime << " usec while " << cydWeeWXFetchStateNames[(int)openMeteoFetch.maxStepState] << ".");
+  LOG_INFO("processOpenMeteoResponse", "Open-Meteo connect and TLS handshake: " << openMeteoFetch.connectTime << " msec (saved session offered: "
+    << openMeteoFetch.sessionOffered << "), peak heap used: " << (int32_t)(openMeteoFetch.heapAtStart - openMeteoFetch.minFreeHeap) << " bytes.");
+
+  if (!openMeteoFetch.failed() && (openMeteoFetch.statusCode == CYD_WWX_HTTP_CODE_OK)) {
+    LOG_DEBUG("processOpenMeteoResponse","Request information:");
+    LOG_DEBUG("processOpenMeteoResponse", openMeteoBody);
+
+    // Parse the JSON to extract the time
+#ifdef CYD_WWX_JSON_ARENA
+    jsonArena.reset();
+    JsonDocument om_doc(&jsonArena);
+#else
+    JsonDocument om_doc;
+#endif  // CYD_WWX_JSON_ARENA
+    DeserializationError error = deserializeJson(om_doc, (const char *)openMeteoBody);
+#ifdef CYD_WWX_JSON_ARENA
+    LOG_INFO("processOpenMeteoResponse", "JsonDocument memory: " << jsonArena.currentSize << " bytes (peak while parsing: " << jsonArena.peakSize
+      << " bytes), JSON arena overflows to the heap: " << jsonArena.overflowCount << ".");
+#endif  // CYD_WWX_JSON_ARENA
+    if (!error) 
+    {
+      openMeteoFailed = false;
+      setWeatherCode(om_doc["current"]["weather_code"]);
+      LOG_INFO("processOpenMeteoResponse", "Open-Meteo weather code: " << networkSnapshot.weatherCode << ", inferred from the station: "
+        << stationWeatherCode << ".");
+      openMeteoCurrentTime = om_doc["current"]["time"];
+      openMeteoInterval = om_doc["current"]["interval"];
+
+      // Keep the hourly forecast so the icon can follow the weather if later queries fail
+      JsonArrayConst hourlyTimes = om_doc["hourly"]["time"];
+      JsonArrayConst hourlyCodes = om_doc["hourly"]["weather_code"];
+      JsonArrayConst::iterator code = hourlyCodes.begin();
+      openMeteoHourlyCount = 0;
+      for (JsonVariantConst time : hourlyTimes) {
+        if ((openMeteoHourlyCount >= CYD_WWX_OPEN_METEO_FORECAST_HOURS) || (code == hourlyCodes.end())) {
+          break;
+        }
+        openMeteoHourlyTimes[openMeteoHourlyCount] = time.as<int64_t>();
+        openMeteoHourlyCodes[openMeteoHourlyCount] = (*code).as<int>();
+        openMeteoHourlyCount += 1;
+        ++code;
+      }
+      LOG_DEBUG("processOpenMeteoResponse", "Current weather code interval: " << openMeteoInterval << " sec, hourly codes cached: "
+        << openMeteoHourlyCount << ".");
+      scheduleNextOpenMeteoQuery();
+      setNetworkErrorState(CYD_WWX_NO_ERROR, String());
+    } else {
+      LOG_ERROR("processOpenMeteoResponse", "deserializeJson() OpenMeteo Response failed: " << error.c_str());
+      setNetworkErrorState(CYD_WWX_NON_CRITICAL_ERROR, String("Deserialization error, cannot retrieve WMO icon."));
+      openMeteoFailed = true;
+    }
+  } else {
+    String reason = openMeteoFetch.failed() ? String(openMeteoFetch.errorMessage) : String(openMeteoFetch.statusCode);
+    LOG_ERROR("processOpenMeteoResponse", "GET request failed, error: " << reason);
+    setNetworkErrorState(CYD_WWX_NON_CRITICAL_ERROR, String("Open-Meteo GET request failed, error: " + reason));
+    openMeteoFailed = true;
+  }
+  updateWeatherCode();
+}
+
+// Show a new WMO weather code
+void setWeatherCode(int weatherCode) {
+  if (weatherCode != networkSnapshot.weatherCode) {
+    networkSnapshot.weatherCode = weatherCode;
+    networkSnapshotChanged = true;
+  }
+}
+
+// Current time estimated from the WeeWX generation epochs, 0 if not known yet. Lags real time by
+// the shortest delay seen between WeeWX generating a report and cydWeeWX receiving it.
+int64_t getEstimatedEpoch() {
+  if (weeWXClockOffset == INT64_MAX) {
+    return 0;
+  }
+  return ((esp_timer_get_time() / 1000) - weeWXClockOffset) / 1000;
+}
+
+// Move the next Open-Meteo query to just after its current weather code is replaced. Keeps the
+// fixed interval until the time is known from WeeWX.
+void scheduleNextOpenMeteoQuery() {
+  int64_t epoch = getEstimatedEpoch();
+  if ((epoch == 0) || (openMeteoInterval <= 0)) {
     return;
   }
-  LOG_DEBUG("getWeeWXData", "getWeeWXData:");
-  if (WiFi.status() == WL_CONNECTED) {
-    
-#ifndef CYD_WWX_RUN_ON_WOKWI  
-    String weeWXJsonUrl = String(cydWeeWXUrl + CYD_WWX_WEEWX_JSON_DATA_FILE);
-    HTTPClient http;
-    LOG_DEBUG("getWeeWXData", "      Request WeeWX Data from: " << weeWXJsonUrl.c_str());
-    http.begin(String(weeWXJsonUrl));
-    int httpCode = http.GET(); // Make the GET request
-#else  //  CYD_WWX_RUN_ON_WOKWI is defined and in WOKWi simulator
-    int httpCode = 200;
-#endif  // ndef CYD_WWX_RUN_ON_WOKWI
-    if (httpCode > 0) {
-      // Check for the response
-      if (httpCode == HTTP_CODE_OK) {
-#ifndef CYD_WWX_RUN_ON_WOKWI 
-        String payload = http.getString();
-#else  //  CYD_WWX_RUN_ON_WOKWI is defined and in WOKWi simulator
-        String payload = String(cydWeeWXWokwiJSON);
-#endif  // ndef CYD_WWX_RUN_ON_WOKWI
-        LOG_DEBUG("getWeeWXData", "Request information:");
-        LOG_DEBUG("getWeeWXData", payload);
-        // Parse the JSON to extract the time
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
-        if (!error) {
-          const char* datetime = doc["generation"]["time"];
-          float tempTemperature = doc["current"]["temperature"]["value"];
-          float temperatureTrend = doc["current"]["temperature trend"]["value"];
-          float tempHumidity = doc["current"]["humidity"]["value"];
-          float humidityTrend = doc["current"]["humidity trend"]["value"];
-          float tempInsideTemperature = doc["current"]["inside temperature"]["value"];
-          float tempInsideHumidity = doc["current"]["inside humidity"]["value"];
-          double tempLat = doc["station"]["latitude"];
-          double tempLong = doc["station"]["longitude"];
-          double tempWind = doc["current"]["wind speed"]["value"];
-          float windTrend = doc["current"]["wind speed trend"]["value"];
-          double tempWindGust = doc["current"]["wind gust"]["value"];
-          float windGustTrend = doc["current"]["wind gust trend"]["value"];
-          double tempWindDir = doc["current"]["wind direction"]["value"];
-          double tempPressure = doc["current"]["barometer"]["value"];
-          double pressureTrend = doc["current"]["barometer trend"]["value"];
-          double tempRainRate = doc["current"]["rain rate"]["value"];
-          double rainRateTrend = doc["current"]["rain rate trend"]["value"];
-          int moonPhasePercent = doc["almanac"]["moon fullness"];
-          bool moonWaxing = doc["almanac"]["moon waxing"];
-          char tbuf[32] = {};
-
-          LOG_DEBUG("getWeeWXData", "Time: " << datetime);
-          LOG_DEBUG("getWeeWXData", "Temperature: " << tempTemperature);
-          LOG_DEBUG("getWeeWXData", "Temperature trend: " << temperatureTrend);
-          LOG_DEBUG("getWeeWXData", "Humidity: " << tempHumidity);
-          LOG_DEBUG("getWeeWXData", "Humidity Trend: " << humidityTrend);
-          LOG_DEBUG("getWeeWXData", "Inside Temperature: " << tempInsideTemperature);
-          LOG_DEBUG("getWeeWXData", "Inside Humidity: " << insideHumidity);
-          LOG_DEBUG("getWeeWXData", "Wind Speed: " << tempWind);
-          LOG_DEBUG("getWeeWXData", "Wind trend: " << windTrend);
-          LOG_DEBUG("getWeeWXData", "Wind Gust: " << tempWindGust);
-          LOG_DEBUG("getWeeWXData", "Wind Gust trend: " << windGustTrend);
-          LOG_DEBUG("getWeeWXData", "Wind Direction: " << tempWindDir);
-          LOG_DEBUG("getWeeWXData", "Pressure: " << tempPressure);
-          LOG_DEBUG("getWeeWXData", "Pressure Trend: " << pressureTrend);
-          LOG_DEBUG("getWeeWXData", "Rain Rate: " << tempRainRate);
-          LOG_DEBUG("getWeeWXData", "Rain Rate Trend: " << rainRateTrend);
-          LOG_DEBUG("getWeeWXData", "Moon Phase %: " << moonPhasePercent);
-          LOG_DEBUG("getWeeWXData", "Longitude: " << tempLong);
-          LOG_DEBUG("getWeeWXData", "Latitude: " << tempLat);
-
-          LOG_DEBUG("getWeeWXData", "      WeeWX Data received.");
-          sprintf(tbuf, "%6.1f", tempTemperature);
-          temperature = String(tbuf);
-          unitsTemperature = String(doc["current"]["temperature"]["units"]);
-          setSensorTrend( temperatureTrend, cydwwxsensor::TEMPERATURE);
-
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%6.1f", tempInsideTemperature);
-          insideTemperature = String(tbuf);
-           
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%2.0f", tempHumidity);
-          humidity = String(tbuf);
-          unitsHumidity = String(doc["current"]["humidity"]["units"]);
-
-          setSensorTrend( humidityTrend, cydwwxsensor::HUMIDITY);
-
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%2.0f", tempInsideHumidity);
-          insideHumidity = String(tbuf);
-
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%6.1f", tempWind);;
-          wind = String(tbuf);
-          unitsWind = String(doc["current"]["wind speed"]["units"]);
-
-          setSensorTrend( windTrend, cydwwxsensor::WIND);
-
-          windDirection = getWindDirectionString(tempWindDir);
-
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%6.1f", tempWindGust);;
-          windGust = String(tbuf);
-          unitsWindGust = String(doc["current"]["wind gust"]["units"]);
-
-          setSensorTrend( windGustTrend, cydwwxsensor::WIND_GUST);
-
-          windGustDirection = getWindDirectionString(tempWindDir);
-
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%4.0f", tempPressure);
-          pressure = String(tbuf);
-          unitsPressure = String(doc["current"]["barometer"]["units"]);
-
-          setSensorTrend( pressureTrend, cydwwxsensor::PRESSURE);
-
-          memset(tbuf, '\0', strlen(tbuf));
-          sprintf(tbuf, "%4.0f", tempRainRate);
-          rainRate = String(tbuf);
-          unitsRainRate = String(doc["current"]["rain rate"]["units"]);
-
-          setSensorTrend( rainRateTrend, cydwwxsensor::RAIN_RATE);
-
-          // Split the datetime into date and time
-          String datetime_str = String(datetime);
-          int splitIndex = datetime_str.indexOf('T');
-
-          location = String(doc["station"]["location"]);
-
-          memset(tbuf,'\0', strlen(tbuf));
-          sprintf(tbuf, "%.3f", tempLat);
-          latitude = String(tbuf);
-          
-          memset(tbuf,'\0', strlen(tbuf));
-          sprintf(tbuf, "%.3f", tempLong);
-          longitude = String(tbuf);
-          
-          screenHeader = String(location + " (Lat:" + latitude + ", Lon:" + longitude + ") - "
-                        + datetime_str.substring(0, splitIndex) + " @" + datetime_str.substring(splitIndex + 1, splitIndex + 6));
-
-          // Almanac items
-          sunrise = String(doc["almanac"]["sunrise"]);
-          sunset = String(doc["almanac"]["sunset"]);
-          moonrise = String(doc["almanac"]["moonrise"]);
-          moonset = String(doc["almanac"]["moonset"]);
-          isDay = ((int)doc["almanac"]["is day"] == 1);
-#ifdef CYD_WWX_RUN_ON_WOKWI
-          if (!(isDay = cydWeeWXWokiIsDay)) { // Override in WOKWi simulator to switch between day and night
-            screenHeader = String(location + " (Lat:" + latitude + ", Lon:" + longitude + ") - "
-                        + datetime_str.substring(0, splitIndex) + " @" + "21:30");
-          }
-#endif // CYD_WWX_RUN_ON_WOKWI
-          LOG_DEBUG("getWeeWXData", "Sunrise: " << sunrise);
-          LOG_DEBUG("getWeeWXData", "Sunset: " << sunset);
-          LOG_DEBUG("getWeeWXData", "Moonrise: " << moonrise);
-          LOG_DEBUG("getWeeWXData", "Moonset: " << moonset);
+  int64_t refreshEvery = (int64_t)openMeteoInterval * CYD_WWX_OPEN_METEO_REFRESH_INTERVALS * 1000;
+  int64_t expected = ((openMeteoCurrentTime - epoch) * 1000) + refreshEvery + CYD_WWX_OPEN_METEO_REFRESH_MARGIN;
+  // Guard against a poor time estimate: never sooner than the margin, never later than one full refresh
+  int64_t wait = constrain(expected, (int64_t)CYD_WWX_OPEN_METEO_REFRESH_MARGIN, refreshEvery + CYD_WWX_OPEN_METEO_REFRESH_MARGIN);
+  openMeteoNextQueryTime = millis() + (uint32_t)wait;
+  LOG_DEBUG("scheduleNextOpenMeteoQuery", "Next Open-Meteo query in " << (int32_t)wait << " msec.");
+}
 
-          setMoonPhaseString( moonPhasePercent, moonWaxing);
+// Once the current weather code has expired, show the cached forecast code for the current hour.
+// Returns false if Open-Meteo has no weather code for the current time.
+bool updateOpenMeteoForecastCode() {
+  int64_t epoch = getEstimatedEpoch();
+  if ((openMeteoHourlyCount == 0) || (epoch == 0)) {
+    return false;
+  }
+  if (epoch < openMeteoCurrentTime + openMeteoInterval) {
+    return true;
+  }
+  if (epoch >= openMeteoHourlyTimes[openMeteoHourlyCount - 1] + 3600) {  // Past the end of the forecast
+    return false;
+  }
+  for (int i = openMeteoHourlyCount - 1; i >= 0; i--) {
+    if (openMeteoHourlyTimes[i] <= epoch) {
+      if (openMeteoHourlyCodes[i] != networkSnapshot.weatherCode) {
+        LOG_INFO("updateOpenMeteoForecastCode", "Weather code from the cached hourly forecast: " << openMeteoHourlyCodes[i] << ".");
+      }
+      setWeatherCode(openMeteoHourlyCodes[i]);
+      return true;
+    }
+  }
+  return false;
+}
 
-          cydWeeWXCurrentTimeInMinutes = datetime_str.substring(splitIndex + 1, splitIndex + 6).substring(0, 2).toInt() * 60 + 
-                                          datetime_str.substring(splitIndex + 1, splitIndex + 6).substring(3, 5).toInt();
-          cydWeeWXSunriseTimeInMinutes = sunrise.substring(0, 2).toInt() * 60 + sunrise.substring(3, 5).toInt();
-          cydWeeWXSunsetTimeInMinutes = sunset.substring(0, 2).toInt() * 60 + sunset.substring(3, 5).toInt();
+// Infer the weather code from the station readings, converted to the metric units the classifier uses
+void updateStationWeatherCode(JsonDocument &doc) {
+  cydWeeWXStationReadings readings;
+  JsonVariantConst value = getWeeWXValue(doc, cydwwxfield::TEMPERATURE);
+  if (!value.isNull()) {
+    readings.temperature = value.as<float>();
+    if (strchr(networkSnapshot.reading(cydwwxsensor::TEMPERATURE).units, 'F') != nullptr) {
+      readings.temperature = (readings.temperature - 32.0f) * 5.0f / 9.0f;
+    }
+  }
+  value = getWeeWXValue(doc, cydwwxfield::HUMIDITY);
+  if (!value.isNull()) {
+    readings.humidity = value.as<float>();
+  }
+  value = getWeeWXValue(doc, cydwwxfield::RAIN_RATE);
+  if (!value.isNull()) {
+    readings.rainRate = value.as<float>();
+    if (strncmp(networkSnapshot.reading(cydwwxsensor::RAIN_RATE).units, "in", 2) == 0) {
+      readings.rainRate *= 25.4f;
+    } else if (strncmp(networkSnapshot.reading(cydwwxsensor::RAIN_RATE).units, "cm", 2) == 0) {
+      readings.rainRate *= 10.0f;
+    }
+  }
+  value = getWeeWXValue(doc, cydwwxfield::PRESSURE_TREND);
+  if (!value.isNull()) {
+    readings.pressureTrend = value.as<float>();
+    if (strncmp(networkSnapshot.reading(cydwwxsensor::PRESSURE).units, "inHg", 4) == 0) {
+      readings.pressureTrend *= 33.8639f;
+    } else if (strncmp(networkSnapshot.reading(cydwwxsensor::PRESSURE).units, "mmHg", 4) == 0) {
+      readings.pressureTrend *= 1.33322f;
+    } else if (strncmp(networkSnapshot.reading(cydwwxsensor::PRESSURE).units, "kPa", 3) == 0) {
+      readings.pressureTrend *= 10.0f;
+    }
+  }
+  readings.isDay = networkSnapshot.isDay;
 
+  stationWeatherCode = cydWeeWXClassifyWmo(readings);
+  LOG_DEBUG("updateStationWeatherCode", "Weather code inferred from the station: " << stationWeatherCode);
+}
 
-        } else {  // DeserializationError error
+// Show the weather code from Open-Meteo, its cached hourly forecast, or the station readings
+void updateWeatherCode() {
+#ifdef CYD_WWX_WMO_STATION_ONLY
+  bool useStation = true;
+#else
+  bool useStation = !updateOpenMeteoForecastCode() && openMeteoFailed;
+#ifndef CYD_WWX_WMO_STATION_FALLBACK
+  useStation = false;
+#endif  // CYD_WWX_WMO_STATION_FALLBACK
+#endif  // CYD_WWX_WMO_STATION_ONLY
+  if (useStation && (stationWeatherCode >= 0)) {
+    setWeatherCode(stationWeatherCode);
+  }
+}
 
-          LOG_ERROR("getWeeWXData", "deserializeJson() failed: " << error.c_str());
+// Deserialize a WeeWX response in the format being queried. The field projection filter is only
+// needed for the full JSON file, the compact feed holds nothing else.
+DeserializationError deserializeWeeWXData(JsonDocument &doc, const char *input, size_t length) {
+  if (weeWXFeedFormat == cydwwxfeedformat::COMPACT_MSGPACK) {
+    return deserializeMsgPack(doc, input, length);
+  } else if (weeWXFeedFormat == cydwwxfeedformat::COMPACT_JSON) {
+    return deserializeJson(doc, input, length);
+  }
+#ifdef CYD_WWX_WEEWX_FILTER_FIELDS
+  return deserializeJson(doc, input, length, DeserializationOption::Filter(weeWXFilter));
+#else
+  return deserializeJson(doc, input, length);
+#endif  // CYD_WWX_WEEWX_FILTER_FIELDS
+}
 
-          setCydWeeWXErrorState(CYD_WWX_CRITICAL_ERROR);
-          errorHeaderMessage = String("WeeWX data deserializeJson() failed: " + String(error.c_str()));
-        } // Not DeserializationError error
- #ifndef CYD_WWX_RUN_ON_WOKWI        
-      } else {  // HTTP_CODE_OK not 200
+// True if text ends with suffix
+bool textEndsWith(const char *text, const char *suffix) {
+  size_t textLength = strlen(text);
+  size_t suffixLength = strlen(suffix);
+  return (textLength >= suffixLength) && (strcmp(text + textLength - suffixLength, suffix) == 0);
+}
 
-        LOG_ERROR("getWeeWXData", "GET request failed, error: " << httpCode << " - " << http.errorToString(httpCode).c_str());
-        setCydWeeWXErrorState(CYD_WWX_CRITICAL_ERROR);
-        errorHeaderMessage = String("WeeWX GET request failed, error: " + String(httpCode));
-      } // HTTP_CODE_OK == 200
-    } else {  // HTTP_CODE_OK < 0 
-      LOG_ERROR("getWeeWXData", "GET request failed, error: " << httpCode << " - " << http.errorToString(httpCode).c_str());
-      setCydWeeWXErrorState(CYD_WWX_CRITICAL_ERROR);
-      errorHeaderMessage = String("WeeWX GET request failed, error: " + String(http.errorToString(httpCode).c_str()));
-    }  // HTTP_CODE_OK >= 0
+// Choose the WeeWX data file format from the data file name
+cydwwxfeedformat getWeeWXFeedFormat(const char *dataFile) {
+  if (textEndsWith(dataFile, ".msgpack")) {
+    return cydwwxfeedformat::COMPACT_MSGPACK;
+  } else if (textEndsWith(dataFile, "_compact.json")) {
+    return cydwwxfeedformat::COMPACT_JSON;
+  }
+  return cydwwxfeedformat::FULL_JSON;
+}
 
-    http.end(); // Close connection
-#else // in WOKWi simulation
-      }
+// Value of a WeeWX field in a parsed document of either format
+JsonVariantConst getWeeWXValue(const JsonDocument &doc, cydwwxfield field) {
+  const weeWXFieldKey &key = weeWXFieldKeys[(unsigned int)field];
+  if (weeWXFeedFormat == cydwwxfeedformat::FULL_JSON) {
+    if (key.hasUnits) {
+      return doc[key.group][key.name]["value"];
+    }
+    return doc[key.group][key.name];
+  }
+  if (key.hasUnits) {
+    return doc[(unsigned int)field][0];
+  }
+  return doc[(unsigned int)field];
+}
+
+// Units of a WeeWX field in a parsed document of either format, nullptr if there are none
+const char *getWeeWXUnits(const JsonDocument &doc, cydwwxfield field) {
+  const weeWXFieldKey &key = weeWXFieldKeys[(unsigned int)field];
+  if (weeWXFeedFormat == cydwwxfeedformat::FULL_JSON) {
+    return doc[key.group][key.name]["units"].as<const char *>();
+  }
+  return doc[(unsigned int)field][1].as<const char *>();
+}
+
+// Format a WeeWX reading into the network snapshot. Returns true if the displayed text changed.
+bool setWeeWXReading(cydwwxfield field, double value) {
+  char tbuf[CYD_WWX_READING_TEXT_LENGTH];
+  char (*reading)[CYD_WWX_READING_TEXT_LENGTH] = nullptr;
+
+  switch (field) {
+    case cydwwxfield::TEMPERATURE:
+      formatFixed(tbuf, sizeof(tbuf), value, 6, 1);
+      reading = &networkSnapshot.reading(cydwwxsensor::TEMPERATURE).value;
+      break;
+    case cydwwxfield::INSIDE_TEMPERATURE:
+      formatFixed(tbuf, sizeof(tbuf), value, 6, 1);
+      reading = &networkSnapshot.insideTemperature;
+      break;
+    case cydwwxfield::HUMIDITY:
+      formatFixed(tbuf, sizeof(tbuf), value, 2, 0);
+      reading = &networkSnapshot.reading(cydwwxsensor::HUMIDITY).value;
+      break;
+    case cydwwxfield::INSIDE_HUMIDITY:
+      formatFixed(tbuf, sizeof(tbuf), value, 2, 0);
+      reading = &networkSnapshot.insideHumidity;
+      break;
+    case cydwwxfield::WIND:
+      formatFixed(tbuf, sizeof(tbuf), value, 6, 1);
+      reading = &networkSnapshot.reading(cydwwxsensor::WIND).value;
+      break;
+    case cydwwxfield::WIND_GUST:
+      formatFixed(tbuf, sizeof(tbuf), value, 6, 1);
+      reading = &networkSnapshot.reading(cydwwxsensor::WIND_GUST).value;
+      break;
+    case cydwwxfield::WIND_DIRECTION:
+    {
+      // There is no separate gust direction so both show the wind direction
+      return setSnapshotText(networkSnapshot.windDirection, getWindDirectionString(value));
+    }
+    case cydwwxfield::PRESSURE:
+      formatFixed(tbuf, sizeof(tbuf), value, 4, 0);
+      reading = &networkSnapshot.reading(cydwwxsensor::PRESSURE).value;
+      break;
+    case cydwwxfield::RAIN_RATE:
+      formatFixed(tbuf, sizeof(tbuf), value, 4, 0);
+      reading = &networkSnapshot.reading(cydwwxsensor::RAIN_RATE).value;
+      break;
+    default:
+      return false;
+  }
+
+  return setSnapshotText(*reading, tbuf);
+}
+
+// Update the WeeWX readings displayed from a parsed WeeWX document
+void updateWeeWXReadings(JsonDocument &doc) {
+  const char* datetime = getWeeWXValue(doc, cydwwxfield::TIME);
+  float tempTemperature = getWeeWXValue(doc, cydwwxfield::TEMPERATURE);
+  float temperatureTrend = getWeeWXValue(doc, cydwwxfield::TEMPERATURE_TREND);
+  float tempHumidity = getWeeWXValue(doc, cydwwxfield::HUMIDITY);
+  float humidityTrend = getWeeWXValue(doc, cydwwxfield::HUMIDITY_TREND);
+  float tempInsideTemperature = getWeeWXValue(doc, cydwwxfield::INSIDE_TEMPERATURE);
+  float tempInsideHumidity = getWeeWXValue(doc, cydwwxfield::INSIDE_HUMIDITY);
+  double tempLat = getWeeWXValue(doc, cydwwxfield::LATITUDE);
+  double tempLong = getWeeWXValue(doc, cydwwxfield::LONGITUDE);
+  double tempWind = getWeeWXValue(doc, cydwwxfield::WIND);
+  float windTrend = getWeeWXValue(doc, cydwwxfield::WIND_TREND);
+  double tempWindGust = getWeeWXValue(doc, cydwwxfield::WIND_GUST);
+  float windGustTrend = getWeeWXValue(doc, cydwwxfield::WIND_GUST_TREND);
+  double tempWindDir = getWeeWXValue(doc, cydwwxfield::WIND_DIRECTION);
+  double tempPressure = getWeeWXValue(doc, cydwwxfield::PRESSURE);
+  double pressureTrend = getWeeWXValue(doc, cydwwxfield::PRESSURE_TREND);
+  double tempRainRate = getWeeWXValue(doc, cydwwxfield::RAIN_RATE);
+  double rainRateTrend = getWeeWXValue(doc, cydwwxfield::RAIN_RATE_TREND);
+  int moonPhasePercent = getWeeWXValue(doc, cydwwxfield::MOON_FULLNESS);
+  bool moonWaxing = getWeeWXValue(doc, cydwwxfield::MOON_WAXING);
+
+  LOG_DEBUG("updateWeeWXReadings", "Time: " << datetime);
+  LOG_DEBUG("updateWeeWXReadings", "Temperature: " << tempTemperature);
+  LOG_DEBUG("updateWeeWXReadings", "Temperature trend: " << temperatureTrend);
+  LOG_DEBUG("updateWeeWXReadings", "Humidity: " << tempHumidity);
+  LOG_DEBUG("updateWeeWXReadings", "Humidity Trend: " << humidityTrend);
+  LOG_DEBUG("updateWeeWXReadings", "Inside Temperature: " << tempInsideTemperature);
+  LOG_DEBUG("updateWeeWXReadings", "Inside Humidity: " << networkSnapshot.insideHumidity);
+  LOG_DEBUG("updateWeeWXReadings", "Wind Speed: " << tempWind);
+  LOG_DEBUG("updateWeeWXReadings", "Wind trend: " << windTrend);
+  LOG_DEBUG("updateWeeWXReadings", "Wind Gust: " << tempWindGust);
+  LOG_DEBUG("updateWeeWXReadings", "Wind Gust trend: " << windGustTrend);
+  LOG_DEBUG("updateWeeWXReadings", "Wind Direction: " << tempWindDir);
+  LOG_DEBUG("updateWeeWXReadings", "Pressure: " << tempPressure);
+  LOG_DEBUG("updateWeeWXReadings", "Pressure Trend: " << pressureTrend);
+  LOG_DEBUG("updateWeeWXReadings", "Rain Rate: " << tempRainRate);
+  LOG_DEBUG("updateWeeWXReadings", "Rain Rate Trend: " << rainRateTrend);
+  LOG_DEBUG("updateWeeWXReadings", "Moon Phase %: " << moonPhasePercent);
+  LOG_DEBUG("updateWeeWXReadings", "Longitude: " << tempLong);
+  LOG_DEBUG("updateWeeWXReadings", "Latitude: " << tempLat);
+
+  LOG_DEBUG("updateWeeWXReadings", "      WeeWX Data received.");
+  setWeeWXReading(cydwwxfield::TEMPERATURE, tempTemperature);
+  setSnapshotText(networkSnapshot.reading(cydwwxsensor::TEMPERATURE).units, getWeeWXUnits(doc, cydwwxfield::TEMPERATURE));
+  setSensorTrend( temperatureTrend, cydwwxsensor::TEMPERATURE);
+
+  setWeeWXReading(cydwwxfield::INSIDE_TEMPERATURE, tempInsideTemperature);
+   
+  setWeeWXReading(cydwwxfield::HUMIDITY, tempHumidity);
+  setSnapshotText(networkSnapshot.reading(cydwwxsensor::HUMIDITY).units, getWeeWXUnits(doc, cydwwxfield::HUMIDITY));
+
+  setSensorTrend( humidityTrend, cydwwxsensor::HUMIDITY);
+
+  setWeeWXReading(cydwwxfield::INSIDE_HUMIDITY, tempInsideHumidity);
+
+  setWeeWXReading(cydwwxfield::WIND, tempWind);
+  setSnapshotText(networkSnapshot.reading(cydwwxsensor::WIND).units, getWeeWXUnits(doc, cydwwxfield::WIND));
+
+  setSensorTrend( windTrend, cydwwxsensor::WIND);
+
+  setWeeWXReading(cydwwxfield::WIND_GUST, tempWindGust);
+  setSnapshotText(networkSnapshot.reading(cydwwxsensor::WIND_GUST).units, getWeeWXUnits(doc, cydwwxfield::WIND_GUST));
+
+  setSensorTrend( windGustTrend, cydwwxsensor::WIND_GUST);
+
+  // Sets both the wind and wind gust direction
+  setWeeWXReading(cydwwxfield::WIND_DIRECTION, tempWindDir);
+
+  setWeeWXReading(cydwwxfield::PRESSURE, tempPressure);
+  setSnapshotText(networkSnapshot.reading(cydwwxsensor::PRESSURE).units, getWeeWXUnits(doc, cydwwxfield::PRESSURE));
+
+  setSensorTrend( pressureTrend, cydwwxsensor::PRESSURE);
+
+  setWeeWXReading(cydwwxfield::RAIN_RATE, tempRainRate);
+  setSnapshotText(networkSnapshot.reading(cydwwxsensor::RAIN_RATE).units, getWeeWXUnits(doc, cydwwxfield::RAIN_RATE));
+
+  setSensorTrend( rainRateTrend, cydwwxsensor::RAIN_RATE);
+
+  // Report time as epoch seconds and UTC offset. The human format names the time zone instead of
+  // giving the offset, so the offset is worked out from the epoch field if the feed has one.
+  char reportDate[CYD_WWX_TIME_TEXT_LENGTH] = "";
+  char reportClock[CYD_WWX_TIME_TEXT_LENGTH] = "";
+  cydWeeWXLocalTime reportTime = {};
+  if (parseWeeWXTimestamp(datetime, weeWXReportTime)) {
+    setUtcOffsetFromEpoch(weeWXReportTime, getWeeWXValue(doc, cydwwxfield::GENERATION_EPOCH).as<int64_t>());
+    reportTime = getLocalTime(weeWXReportTime.localTime());
+    snprintf(reportDate, sizeof(reportDate), "%04d-%02d-%02d", reportTime.year, reportTime.month, reportTime.day);
+    snprintf(reportClock, sizeof(reportClock), "%02d:%02d", reportTime.secondOfDay / 3600, (reportTime.secondOfDay / 60) % 60);
+    LOG_DEBUG("updateWeeWXReadings", "Report epoch: " << (int32_t)weeWXReportTime.epoch << ", UTC offset: " << weeWXReportTime.utcOffset
+      << " sec" << (weeWXReportTime.hasOffset ? "." : " (not known)."));
+  } else {
+    LOG_ERROR("updateWeeWXReadings", "Cannot read the WeeWX report time: " << ((datetime != nullptr) ? datetime : "(none)"));
+    weeWXReportTime = cydWeeWXTimestamp();
+    setSnapshotText(reportDate, datetime);
+  }
+
+  setSnapshotText(networkSnapshot.location, getWeeWXValue(doc, cydwwxfield::LOCATION).as<const char *>());
+  formatFixed(networkSnapshot.latitude, sizeof(networkSnapshot.latitude), tempLat, 0, 3);
+  formatFixed(networkSnapshot.longitude, sizeof(networkSnapshot.longitude), tempLong, 0, 3);
+  if (!stationLatitude.equals(networkSnapshot.latitude) || !stationLongitude.equals(networkSnapshot.longitude)) {
+    saveStationLocation(String(networkSnapshot.latitude), String(networkSnapshot.longitude));
+  }
+  
+  snprintf(networkSnapshot.screenHeader, sizeof(networkSnapshot.screenHeader), "%s (Lat:%s, Lon:%s) - %s @%s", networkSnapshot.location,
+           networkSnapshot.latitude, networkSnapshot.longitude, reportDate, reportClock);
+
+  // Almanac items
+  setSnapshotText(networkSnapshot.sunrise, getWeeWXValue(doc, cydwwxfield::SUNRISE).as<const char *>());
+  setSnapshotText(networkSnapshot.sunset, getWeeWXValue(doc, cydwwxfield::SUNSET).as<const char *>());
+  setSnapshotText(networkSnapshot.moonrise, getWeeWXValue(doc, cydwwxfield::MOONRISE).as<const char *>());
+  setSnapshotText(networkSnapshot.moonset, getWeeWXValue(doc, cydwwxfield::MOONSET).as<const char *>());
+  networkSnapshot.isDay = (getWeeWXValue(doc, cydwwxfield::IS_DAY).as<int>() == 1);
+#ifdef CYD_WWX_RUN_ON_WOKWI
+  if (!(networkSnapshot.isDay = networkConfig->wokwiIsDay)) { // Override in WOKWi simulator to switch between day and night
+    snprintf(networkSnapshot.screenHeader, sizeof(networkSnapshot.screenHeader), "%s (Lat:%s, Lon:%s) - %s @21:30", networkSnapshot.location,
+             networkSnapshot.latitude, networkSnapshot.longitude, reportDate);
+  }
+#endif // CYD_WWX_RUN_ON_WOKWI
+  LOG_DEBUG("updateWeeWXReadings", "Sunrise: " << networkSnapshot.sunrise);
+  LOG_DEBUG("updateWeeWXReadings", "Sunset: " << networkSnapshot.sunset);
+  LOG_DEBUG("updateWeeWXReadings", "Moonrise: " << networkSnapshot.moonrise);
+  LOG_DEBUG("updateWeeWXReadings", "Moonset: " << networkSnapshot.moonset);
+
+  setMoonPhaseString( moonPhasePercent, moonWaxing);
+
+  // Station local times used by the backlight dimmer. 0 when there is no sunrise or sunset.
+  int sunrise = parseAlmanacTime(networkSnapshot.sunrise);
+  int sunset = parseAlmanacTime(networkSnapshot.sunset);
+  networkSnapshot.currentTimeInMinutes = reportTime.secondOfDay / 60;
+  networkSnapshot.sunriseTimeInMinutes = (sunrise >= 0) ? sunrise / 60 : 0;
+  networkSnapshot.sunsetTimeInMinutes = (sunset >= 0) ? sunset / 60 : 0;
+
+  updateStationWeatherCode(doc);
+  updateWeatherCode();
+
+  networkSnapshotChanged = true;
+}
+
+// Start a WeeWX server query to update current weather data. The response is handled by processWeeWXResponse().
+void getWeeWXData() {
+  LOG_DEBUG("getWeeWXData", "getWeeWXData:");
+  if ((WiFi.status() == WL_CONNECTED) && ((uint32_t)WiFi.localIP() != 0)) {
+    if (weeWXFetch.isBusy()) {
+      LOG_INFO("getWeeWXData", "Previous WeeWX query still in progress, skipping.");
+      return;
+    }
+    weeWXHeapBeforeQuery = ESP.getFreeHeap();
+    // Fixed buffers rather than Strings, so a poll makes no heap allocations
+    char weeWXJsonUrl[CYD_WWX_STRING_FIELD_LENGTH + sizeof(CYD_WWX_WEEWX_JSON_DATA_FILE)];
+    snprintf(weeWXJsonUrl, sizeof(weeWXJsonUrl), "%s%s", networkConfig->weeWXUrl.c_str(), CYD_WWX_WEEWX_JSON_DATA_FILE);
+    weeWXFeedFormat = getWeeWXFeedFormat(CYD_WWX_WEEWX_JSON_DATA_FILE);
+    LOG_DEBUG("getWeeWXData", "      Request WeeWX Data from: " << weeWXJsonUrl);
+    char extraHeaders[2 * CYD_WWX_FETCH_VALIDATOR_LENGTH + 40] = "";
+#ifdef CYD_WWX_WEEWX_CONDITIONAL_GET
+    // Only transfer the file if it changed since the last good response
+    size_t extraLength = 0;
+    if (weeWXETag[0] != '\0') {
+      extraLength += snprintf(extraHeaders, sizeof(extraHeaders), "If-None-Match: %s\r\n", weeWXETag);
+    }
+    if (weeWXLastModified[0] != '\0') {
+      snprintf(extraHeaders + extraLength, sizeof(extraHeaders) - extraLength, "If-Modified-Since: %s\r\n", weeWXLastModified);
+    }
+#endif  // CYD_WWX_WEEWX_CONDITIONAL_GET
+#ifdef CYD_WWX_WEEWX_KEEP_ALIVE
+    bool keepAlive = true;  // Keep the connection open so the next poll skips DNS and the TCP handshake
+#else
+    bool keepAlive = false;
+#endif  // CYD_WWX_WEEWX_KEEP_ALIVE
+    if (!weeWXFetch.begin(weeWXJsonUrl, extraHeaders, keepAlive)) {
+      processWeeWXResponse();
     }
-#endif  // CYD_WWX_RUN_ON_WOKWI
   } else {  // Not connected to WiFi
     LOG_ERROR("getWeeWXData", "Not connected to Wi-Fi");
-    setCydWeeWXErrorState(CYD_WWX_CRITICAL_ERROR);
-    errorHeaderMessage = String("Not connected to Wi-Fi");
+    setNetworkErrorState(CYD_WWX_CRITICAL_ERROR, String("Not connected to Wi-Fi"));
+    updateWeeWXRecovery(cydwwxqueryfailure::LOCAL);
   } // Connected to WiFi
 }
 
+// Handle a finished WeeWX query
+void processWeeWXResponse() {
+  int httpCode = weeWXFetch.failed() ? -1 : weeWXFetch.statusCode;
+  size_t bodyLength = weeWXFetch.bodyLength;
+  LOG_INFO("processWeeWXResponse", "WeeWX query took " << weeWXFetch.elapsed() << " msec in " << weeWXFetch.stepCount
+    << " steps, longest step: " << weeWXFetch.maxStepTime << " usec while " << cydWeeWXFetchStateNames[(int)weeWXFetch.maxStepState]
+    << ", longest loop pass: " << loopMaxPassTime.exchange(0) << " usec.");
+  if (!weeWXFetch.connectionReused) {
+    LOG_INFO("processWeeWXResponse", "WeeWX name lookup: " << weeWXFetch.resolveTime << " usec, connect: " << weeWXFetch.connectTime << " msec.");
+#ifdef CYD_WWX_WEEWX_RESOLVER_CACHE
+    LOG_INFO("processWeeWXResponse", "WeeWX address lookups: " << weeWXResolver.lookups << ", cached: " << weeWXResolver.cacheHits
+      << ", last known used: " << weeWXResolver.fallbacks << ", failed: " << weeWXResolver.failures << ".");
+#endif  // CYD_WWX_WEEWX_RESOLVER_CACHE
+  }
+#ifdef CYD_WWX_WEEWX_GZIP
+  if (weeWXFetch.gzipped) {
+    LOG_INFO("processWeeWXResponse", "WeeWX response gzip encoded: " << weeWXFetch.encodedLength << " bytes received, inflated to "
+      << bodyLength << " bytes in " << weeWXFetch.inflateTime << " usec.");
+  }
+#endif  // CYD_WWX_WEEWX_GZIP
+#ifdef CYD_WWX_WEEWX_KEEP_ALIVE
+  if (httpCode > 0) {
+    if (weeWXFetch.connectionReused) {
+      weeWXConnectionReusedCount += 1;
+    } else {
+      weeWXConnectionNewCount += 1;
+    }
+    LOG_INFO("processWeeWXResponse", "WeeWX connections reused: " << weeWXConnectionReusedCount << ", new: " << weeWXConnectionNewCount << ".");
+  }
+#endif  // CYD_WWX_WEEWX_KEEP_ALIVE
+  weeWXPollCount += 1;
+  cydwwxqueryfailure queryFailure = cydwwxqueryfailure::SERVER;
+
+  if (httpCode == CYD_WWX_HTTP_CODE_OK) {
+    // Parse the JSON to extract the time
+#ifdef CYD_WWX_JSON_ARENA
+    cydWeeWXArenaAllocator &docAllocator = jsonArena;
+    docAllocator.reset();
+#else
+    cydWeeWXCountingAllocator docAllocator;
+#endif  // CYD_WWX_JSON_ARENA
+    JsonDocument doc(&docAllocator);
+    DeserializationError error = DeserializationError::Ok;
+    bool bodyUnchanged = false;
+    int64_t parseStart = esp_timer_get_time();
+    // The fetch fails a body that does not fit the buffer, so a body here is always whole
+#ifdef CYD_WWX_WEEWX_HASH_DEDUPE
+    // Only parse the body if it changed since the last good response. The fetch hashed it as it arrived.
+    uint32_t bodyHash = weeWXFetch.bodyHash;
+    bodyUnchanged = weeWXBodyHashValid && (bodyHash == weeWXBodyHash);
+#endif  // CYD_WWX_WEEWX_HASH_DEDUPE
+    if (weeWXFeedFormat != cydwwxfeedformat::COMPACT_MSGPACK) {
+      LOG_DEBUG("processWeeWXResponse", "Request information:");
+      LOG_DEBUG("processWeeWXResponse", weeWXBody);
+    }
+    if (!bodyUnchanged) {
+      error = deserializeWeeWXData(doc, (const char *)weeWXBody, bodyLength);
+    }
+    // The document is still allocated so this is the poll's peak
+    uint32_t heapAtPeak = ESP.getFreeHeap();
+    LOG_INFO("processWeeWXResponse", "Poll peak heap used: " << (int32_t)(weeWXHeapBeforeQuery - heapAtPeak) << " bytes, parse time: "
+      << (int32_t)(esp_timer_get_time() - parseStart) << " usec, free heap: " << heapAtPeak << " bytes.");
+    LOG_INFO("processWeeWXResponse", "WeeWX response: " << bodyLength << " bytes, JsonDocument memory: " << docAllocator.currentSize
+      << " bytes (peak while parsing: " << docAllocator.peakSize << " bytes).");
+#ifdef CYD_WWX_JSON_ARENA
+    LOG_INFO("processWeeWXResponse", "JSON arena: " << CYD_WWX_JSON_ARENA_SIZE << " bytes, overflows to the heap: " << docAllocator.overflowCount << ".");
+#endif  // CYD_WWX_JSON_ARENA
+    if (bodyUnchanged) {
+      queryFailure = cydwwxqueryfailure::NONE;
+#ifdef CYD_WWX_WEEWX_HASH_DEDUPE
+      weeWXUnchangedCount += 1;
+      LOG_INFO("processWeeWXResponse", "WeeWX data unchanged. Skipped parses: " << weeWXUnchangedCount << " of " << weeWXPollCount << " polls.");
+#endif  // CYD_WWX_WEEWX_HASH_DEDUPE
+    } else if (!error) {
+#ifdef CYD_WWX_WEEWX_HASH_DEDUPE
+      weeWXBodyHash = bodyHash;
+      weeWXBodyHashValid = true;
+#endif  // CYD_WWX_WEEWX_HASH_DEDUPE
+#ifdef CYD_WWX_WEEWX_CONDITIONAL_GET
+      // Remember the validators of this good response for the next conditional GET
+      strcpy(weeWXETag, weeWXFetch.eTag);
+      strcpy(weeWXLastModified, weeWXFetch.lastModified);
+#endif  // CYD_WWX_WEEWX_CONDITIONAL_GET
+      queryFailure = cydwwxqueryfailure::NONE;
+      updateWeeWXReadings(doc);
+      noteWeeWXGeneration(weeWXReportTime.hasOffset ? weeWXReportTime.epoch : 0);
+    } else {  // DeserializationError error
+
+      LOG_ERROR("processWeeWXResponse", "deserializeJson() failed: " << error.c_str());
+
+      setNetworkErrorState(CYD_WWX_CRITICAL_ERROR, String("WeeWX data deserializeJson() failed: " + String(error.c_str())));
+    } // Not DeserializationError error
+  } else if (httpCode == CYD_WWX_HTTP_CODE_NOT_MODIFIED) {  // Same data as the last poll, nothing to parse or display
+    queryFailure = cydwwxqueryfailure::NONE;
+    weeWXNotModifiedCount += 1;
+    LOG_INFO("processWeeWXResponse", "WeeWX data not modified. Skipped transfers: " << weeWXNotModifiedCount << " of " << weeWXPollCount << " polls.");
+  } else if (httpCode > 0) {  // Not CYD_WWX_HTTP_CODE_OK
+    LOG_ERROR("processWeeWXResponse", "GET request failed, error: " << httpCode);
+    setNetworkErrorState(CYD_WWX_CRITICAL_ERROR, String("WeeWX GET request failed, error: " + String(httpCode)));
+  } else {  // No HTTP response
+    LOG_ERROR("processWeeWXResponse", "GET request failed, error: " << weeWXFetch.errorMessage);
+    if (weeWXFetch.failedState == cydwwxfetchstate::CONNECTING) {
+      queryFailure = cydwwxqueryfailure::LOCAL;  // The server was never reached
+    }
+    setNetworkErrorState(CYD_WWX_CRITICAL_ERROR, String("WeeWX GET request failed, error: " + String(weeWXFetch.errorMessage)));
+  }
+#ifdef CYD_WWX_WEEWX_ADAPTIVE_POLL
+  scheduleNextWeeWXQuery();
+#endif  // CYD_WWX_WEEWX_ADAPTIVE_POLL
+  updateWeeWXRecovery(queryFailure);  // After scheduling so a backoff replaces the normal next query
+}
+
+// Step through the recovery ladder after a WeeWX query. A failure backs off the next query with jitter.
+// Failures on this side then reset WiFi and, as the last resort, reboot. A server that answers with an
+// error or bad data is only retried, as neither would fix it. A success ends the outage and logs the time to recover.
+void updateWeeWXRecovery(cydwwxqueryfailure queryFailure) {
+  int64_t now = esp_timer_get_time();
+
+  if (queryFailure == cydwwxqueryfailure::NONE) {
+    if (networkSnapshot.errorState == CYD_WWX_CRITICAL_ERROR) {
+      setNetworkErrorState(CYD_WWX_NO_ERROR, String());
+    }
+    if (recoveryFailures > 0) {
+      int64_t outage = now - recoveryStartTime;
+      recoveryCount += 1;
+      recoveryTotalTime += outage;
+      LOG_INFO("updateWeeWXRecovery", "Recovered after " << recoveryFailures << " failed WeeWX queries in " << (int32_t)(outage / 1000)
+        << " msec. Mean time to recover: " << (int32_t)(recoveryTotalTime / recoveryCount / 1000) << " msec over " << recoveryCount << " outages.");
+      recoveryFailures = 0;
+      recoveryLocalFailures = 0;
+      networkSnapshot.recoveryFailures = 0;
+      networkSnapshot.recoveryRebootNext = false;
+      networkSnapshotChanged = true;
+    }
+    return;
+  }
+
+  if (recoveryFailures == 0) {
+    recoveryStartTime = now;
+  }
+  recoveryFailures += 1;
+  if (queryFailure == cydwwxqueryfailure::LOCAL) {
+    if (recoveryLocalFailures == 0) {
+      recoveryLocalStartTime = now;
+    }
+    recoveryLocalFailures += 1;
+  } else {
+    recoveryLocalFailures = 0;  // The server was reached, so WiFi and the network stack are working
+  }
+
+  int32_t localOutage = (recoveryLocalFailures > 0) ? (int32_t)((now - recoveryLocalStartTime) / 1000) : 0;
+  if ((recoveryLocalFailures > 0) && (localOutage >= CYD_WWX_RECOVERY_REBOOT_AFTER)) {
+    LOG_ERROR("updateWeeWXRecovery", recoveryLocalFailures << " WeeWX queries could not reach the server over " << localOutage << " msec. Rebooting device.");
+    ESP.restart();
+  }
+  if (recoveryLocalFailures == CYD_WWX_RECOVERY_WIFI_RESET_AFTER) {
+    LOG_INFO("updateWeeWXRecovery", recoveryLocalFailures << " WeeWX queries could not reach the server. Resetting WiFi.");
+    weeWXFetch.close();
+    openMeteoFetch.close();
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_STA);
+    WiFi.begin();  // Reconnect with the saved credentials
+  }
+
+  // Exponential backoff, with up to half of it random so a group of displays does not retry together
+  uint32_t backoff = CYD_WWX_RECOVERY_BACKOFF_MAX;
+  if (recoveryFailures <= 16) {
+    backoff = min((uint32_t)CYD_WWX_RECOVERY_BACKOFF_BASE << (recoveryFailures - 1), (uint32_t)CYD_WWX_RECOVERY_BACKOFF_MAX);
+  }
+  backoff = backoff / 2 + random(backoff / 2 + 1);
+  weeWXNextQueryTime = millis() + backoff;
+  LOG_INFO("updateWeeWXRecovery", "WeeWX query failure " << recoveryFailures << ((queryFailure == cydwwxqueryfailure::LOCAL) ? " (server not reached)" : "")
+    << ", retrying in " << backoff << " msec.");
+
+  networkSnapshot.recoveryFailures = recoveryFailures;
+  networkSnapshot.recoveryRetryTime = weeWXNextQueryTime;
+  networkSnapshot.recoveryRebootNext = (recoveryLocalFailures > 0) && (localOutage + (int32_t)backoff >= CYD_WWX_RECOVERY_REBOOT_AFTER);
+  networkSnapshotChanged = true;
+}
+
+// Weather description text while in the critical error state. Written to recoveryMessage, which the label shows in place.
+const char *getRecoveryMessage() {
+  int32_t wait = max((int32_t)(weather->recoveryRetryTime - millis()), (int32_t)0) / 1000;
+  if (weather->wifiDown) {
+    snprintf(recoveryMessage, sizeof(recoveryMessage), "Waiting for Wi-Fi. Reboot if not back in: %ld seconds.", (long)wait);
+  } else if (weather->recoveryRebootNext) {
+    snprintf(recoveryMessage, sizeof(recoveryMessage), "Error state. Reboot after retry in: %ld seconds.", (long)wait);
+  } else {
+    snprintf(recoveryMessage, sizeof(recoveryMessage), "Error state. Retry %lu in: %ld seconds.", (unsigned long)weather->recoveryFailures, (long)wait);
+  }
+  return recoveryMessage;
+}
+
+// Learn the WeeWX report period and log how stale the data was when it arrived. Called for each new WeeWX file.
+void noteWeeWXGeneration(int64_t epoch) {
+  if ((epoch <= 0) || (epoch == weeWXLastEpoch)) {  // Report time not known, or the same report
+    return;
+  }
+  int64_t offset = (esp_timer_get_time() / 1000) - (epoch * 1000);
+  if (offset < weeWXClockOffset) {
+    weeWXClockOffset = offset;
+  }
+
+  if (weeWXLastEpoch > 0) {
+    int64_t period = epoch - weeWXLastEpoch;
+    if (period <= 0) {  // Server clock went back, start learning again
+      weeWXReportPeriod = 0;
+      weeWXReportPeriodMatches = 0;
+    } else if (period == weeWXReportPeriod) {
+      weeWXReportPeriodMatches += 1;
+    } else if ((weeWXReportPeriod <= 0) || (period % weeWXReportPeriod != 0)) {  // A multiple is a missed report
+      weeWXReportPeriod = period;
+      weeWXReportPeriodMatches = 1;
+    }
+  }
+  weeWXLastEpoch = epoch;
+
+  int64_t staleness = (offset - weeWXClockOffset) / 1000;
+  unsigned int bucket = 0;
+  while ((bucket < sizeof(weeWXStalenessLimits) / sizeof(weeWXStalenessLimits[0])) && (staleness >= weeWXStalenessLimits[bucket])) {
+    bucket += 1;
+  }
+  weeWXStalenessCounts[bucket] += 1;
+  weeWXStalenessTotal += staleness;
+  if (staleness > weeWXStalenessMax) {
+    weeWXStalenessMax = staleness;
+  }
+
+  uint32_t samples = 0;
+  for (uint32_t count : weeWXStalenessCounts) {
+    samples += count;
+  }
+  LOG_INFO("noteWeeWXGeneration", "WeeWX data " << (int32_t)staleness << " sec stale, report period: " << (int32_t)weeWXReportPeriod
+    << " sec (seen " << weeWXReportPeriodMatches << " times).");
+  LOG_INFO("noteWeeWXGeneration", "WeeWX staleness (sec) <10: " << weeWXStalenessCounts[0] << ", <30: " << weeWXStalenessCounts[1]
+    << ", <60: " << weeWXStalenessCounts[2] << ", <120: " << weeWXStalenessCounts[3] << ", <300: " << weeWXStalenessCounts[4]
+    << ", 300+: " << weeWXStalenessCounts[5] << ", mean: " << (int32_t)(weeWXStalenessTotal / samples)
+    << ", max: " << (int32_t)weeWXStalenessMax << ".");
+}
+
+#ifdef CYD_WWX_WEEWX_ADAPTIVE_POLL
+// Move the next WeeWX query to just after the next report is expected. Keeps the fixed interval until
+// the report period has been seen often enough, or if the reports have stopped arriving on time.
+void scheduleNextWeeWXQuery() {
+  if (weeWXReportPeriodMatches < CYD_WWX_ADAPTIVE_POLL_MATCHES) {
+    return;
+  }
+  int64_t now = esp_timer_get_time() / 1000;
+  int64_t expected = ((weeWXLastEpoch + weeWXReportPeriod) * 1000) + weeWXClockOffset + CYD_WWX_ADAPTIVE_POLL_MARGIN;
+  if (now - expected > weeWXReportPeriod * 1000) {
+    LOG_INFO("scheduleNextWeeWXQuery", "WeeWX report overdue, back to the fixed polling interval.");
+    weeWXReportPeriodMatches = 0;
+    return;
+  }
+  // Retry shortly while the expected report has not shown up yet
+  int64_t wait = max(expected - now, (int64_t)CYD_WWX_ADAPTIVE_POLL_RETRY);
+  weeWXNextQueryTime = millis() + (uint32_t)wait;
+  LOG_DEBUG("scheduleNextWeeWXQuery", "Next WeeWX query in " << (int32_t)wait << " msec.");
+}
+#endif  // CYD_WWX_WEEWX_ADAPTIVE_POLL
+
+// Load the station location saved by saveStationLocation(). Called by the network task.
+void loadStationLocation() {
+  Preferences locationPreference;  // Own instance as the main loop may be using cydWeeWXPreference
+  locationPreference.begin(CYD_WWX_PREFERENCES_NAMESPACE, CYD_WWX_PREFERENCES_RO);
+  stationLatitude = locationPreference.getString(CYD_WWX_PREF_KEY_LATITUDE, String());
+  stationLongitude = locationPreference.getString(CYD_WWX_PREF_KEY_LONGITUDE, String());
+  locationPreference.end();
+  LOG_DEBUG("loadStationLocation", "Saved station location: " << stationLatitude << ", " << stationLongitude);
+}
+
+// Use a new station location for the Open-Meteo queries and save it for the next boot. Called by the network task.
+void saveStationLocation(const String &latitude, const String &longitude) {
+  stationLatitude = latitude;
+  stationLongitude = longitude;
+  stationLocationChanged = true;
+  Preferences locationPreference;
+  locationPreference.begin(CYD_WWX_PREFERENCES_NAMESPACE, CYD_WWX_PREFERENCES_RW);
+  locationPreference.putString(CYD_WWX_PREF_KEY_LATITUDE, latitude);
+  locationPreference.putString(CYD_WWX_PREF_KEY_LONGITUDE, longitude);
+  locationPreference.end();
+  LOG_INFO("saveStationLocation", "Station location saved: " << latitude << ", " << longitude);
+}
+
 // Load the WeeWX server URL from Preferences
 void loadCydWeeWXConfig() {
 
@@ -1847,6 +2960,12 @@ void loadCydWeeWXConfig() {
   LOG_DEBUG("loadCydWeeWxConfig", "Load config from preferences (WeeWX URL): " << cydWeeWXUrl.c_str());
   cydWeeWXHostname = cydWeeWXPreference.getString(CYD_WWX_PREF_KEY_HOSTNAME, cydWeeWXHostname);
   LOG_DEBUG("loadCydWeeWxConfig", "Hostname: " << cydWeeWXHostname.c_str());
+  cydWeeWXStaticIp = cydWeeWXPreference.getString(CYD_WWX_PREF_KEY_STATIC_IP, cydWeeWXStaticIp);
+  cydWeeWXStaticGateway = cydWeeWXPreference.getString(CYD_WWX_PREF_KEY_STATIC_GATEWAY, cydWeeWXStaticGateway);
+  cydWeeWXStaticSubnet = cydWeeWXPreference.getString(CYD_WWX_PREF_KEY_STATIC_SUBNET, cydWeeWXStaticSubnet);
+  cydWeeWXStaticDns = cydWeeWXPreference.getString(CYD_WWX_PREF_KEY_STATIC_DNS, cydWeeWXStaticDns);
+  LOG_DEBUG("loadCydWeeWxConfig", "Static IP: " << cydWeeWXStaticIp << " Gateway: " << cydWeeWXStaticGateway << " Subnet: "
+    << cydWeeWXStaticSubnet << " DNS: " << cydWeeWXStaticDns);
   cydWeeWXBlMax = cydWeeWXPreference.getUShort(CYD_WWX_PREF_KEY_MAX_BRIGHTNESS, cydWeeWXBlMax);
   LOG_DEBUG("loadCydWeeWxConfig", "Max Brightness (0-255): " << String(cydWeeWXBlMax));
   cydWeeWXBlMin = cydWeeWXPreference.getUShort(CYD_WWX_PREF_KEY_MIN_BRIGHTNESS, cydWeeWXBlMin);
@@ -1889,6 +3008,13 @@ void saveCydWeeWxConfig() {
   cydWeeWXHostname = String(buf);
   LOG_DEBUG("saveCydWeeWxConfig", "Hostname: " << String(buf));
 
+  cydWeeWXStaticIp = String(wmStaticIp->getValue());
+  cydWeeWXStaticGateway = String(wmStaticGateway->getValue());
+  cydWeeWXStaticSubnet = String(wmStaticSubnet->getValue());
+  cydWeeWXStaticDns = String(wmStaticDns->getValue());
+  LOG_DEBUG("saveCydWeeWxConfig", "Static IP: " << cydWeeWXStaticIp << " Gateway: " << cydWeeWXStaticGateway << " Subnet: "
+    << cydWeeWXStaticSubnet << " DNS: " << cydWeeWXStaticDns);
+
   memset(buf, '\0', strlen(buf));
   strlcpy(buf, screenMaxBrightnessHidden->getValue(), sizeof(buf));
   cydWeeWXBlMax = atoi(buf);
@@ -1904,19 +3030,23 @@ void saveCydWeeWxConfig() {
   cydWeeWXBlDimmerMode = (cydwwxdimmermode)atoi(buf);
   LOG_DEBUG("saveCydWeeWxConfig", "Dimmer Selection (0-4): " << String(buf));
 
-  memset(buf, '\0', strlen(buf));
-  strlcpy(buf, dimmerStartTimeHidden->getValue(), sizeof(buf));
-  cydWeeWXDimmerStartHour = String(buf).substring(0, 2).toInt();
-  cydWeeWXDimmerStartMinute = String(buf).substring(3, 5).toInt();
-  cydWeeWXDimmerStartTimeInMinutes = cydWeeWXDimmerStartHour * 60 + cydWeeWXDimmerStartMinute;
-  LOG_DEBUG("saveCydWeeWxConfig", "Dimmer Start Time (HH:MM): " << String(buf));
-
-  memset(buf, '\0', strlen(buf));
-  strlcpy(buf, dimmerEndTimeHidden->getValue(), sizeof(buf));
-  cydWeeWXDimmerEndHour = String(buf).substring(0, 2).toInt();
-  cydWeeWXDimmerEndMinute = String(buf).substring(3, 5).toInt();
-  cydWeeWXDimmerEndTimeInMinutes = cydWeeWXDimmerEndHour * 60 + cydWeeWXDimmerEndMinute;
-  LOG_DEBUG("saveCydWeeWxConfig", "Dimmer End Time (HH:MM): " << String(buf));
+  const char *dimmerStartText = dimmerStartTimeHidden->getValue();
+  int dimmerStart = parseClockTime(dimmerStartText);
+  if (dimmerStart >= 0) {  // Keep the current time if the field is not HH:MM
+    cydWeeWXDimmerStartHour = dimmerStart / 3600;
+    cydWeeWXDimmerStartMinute = (dimmerStart / 60) % 60;
+    cydWeeWXDimmerStartTimeInMinutes = dimmerStart / 60;
+  }
+  LOG_DEBUG("saveCydWeeWxConfig", "Dimmer Start Time (HH:MM): " << dimmerStartTimeHidden->getValue());
+
+  const char *dimmerEndText = dimmerEndTimeHidden->getValue();
+  int dimmerEnd = parseClockTime(dimmerEndText);
+  if (dimmerEnd >= 0) {  // Keep the current time if the field is not HH:MM
+    cydWeeWXDimmerEndHour = dimmerEnd / 3600;
+    cydWeeWXDimmerEndMinute = (dimmerEnd / 60) % 60;
+    cydWeeWXDimmerEndTimeInMinutes = dimmerEnd / 60;
+  }
+  LOG_DEBUG("saveCydWeeWxConfig", "Dimmer End Time (HH:MM): " << dimmerEndTimeHidden->getValue());
 
   memset(buf, '\0', strlen(buf));
   strlcpy(buf, riseSetOffsetHidden->getValue(), sizeof(buf));
@@ -1937,6 +3067,10 @@ void saveCydWeeWxConfig() {
   cydWeeWXPreference.begin(CYD_WWX_PREFERENCES_NAMESPACE, CYD_WWX_PREFERENCES_RW);
   cydWeeWXPreference.putString(CYD_WWX_PREF_KEY_URL, cydWeeWXUrl);
   cydWeeWXPreference.putString(CYD_WWX_PREF_KEY_HOSTNAME, cydWeeWXHostname);
+  cydWeeWXPreference.putString(CYD_WWX_PREF_KEY_STATIC_IP, cydWeeWXStaticIp);
+  cydWeeWXPreference.putString(CYD_WWX_PREF_KEY_STATIC_GATEWAY, cydWeeWXStaticGateway);
+  cydWeeWXPreference.putString(CYD_WWX_PREF_KEY_STATIC_SUBNET, cydWeeWXStaticSubnet);
+  cydWeeWXPreference.putString(CYD_WWX_PREF_KEY_STATIC_DNS, cydWeeWXStaticDns);
   cydWeeWXPreference.putUShort(CYD_WWX_PREF_KEY_MAX_BRIGHTNESS, cydWeeWXBlMax);
   cydWeeWXPreference.putUShort(CYD_WWX_PREF_KEY_MIN_BRIGHTNESS, cydWeeWXBlMin);
   cydWeeWXPreference.putUShort(CYD_WWX_PREF_KEY_DIMMER_MODE, (uint16_t)cydWeeWXBlDimmerMode);
@@ -1950,6 +3084,112 @@ void saveCydWeeWxConfig() {
   cydWeeWXPreference.end();
 }
 
+// Use the static IP settings from the Configuration Portal, for both WiFi Manager and wifiFastConnect().
+// Returns false if DHCP is to be used.
+bool applyStaticIp() {
+  IPAddress ip;
+  IPAddress gateway;
+  IPAddress subnet;
+  IPAddress dns;
+  if (cydWeeWXStaticIp.isEmpty()) {
+    return false;
+  }
+  if (!ip.fromString(cydWeeWXStaticIp) || !gateway.fromString(cydWeeWXStaticGateway) || !subnet.fromString(cydWeeWXStaticSubnet)) {
+    LOG_ERROR("applyStaticIp", "Static IP settings are not valid, using DHCP.");
+    return false;
+  }
+  if (!dns.fromString(cydWeeWXStaticDns)) {
+    dns = gateway;
+  }
+  WiFi.config(ip, gateway, subnet, dns);
+  wm.setSTAStaticIPConfig(ip, gateway, subnet, dns);
+  LOG_INFO("applyStaticIp", "Using static IP: " << cydWeeWXStaticIp);
+  return true;
+}
+
+#ifdef CYD_WWX_WIFI_FAST_CONNECT
+// Wait for the WiFi connection started by WiFi.begin(). Returns true if it connected.
+bool waitForWiFi(uint32_t connectStart) {
+  while ((WiFi.status() != WL_CONNECTED) && (millis() - connectStart < CYD_WWX_WIFI_FAST_CONNECT_TIMEOUT)) {
+    delay(10);
+  }
+  return WiFi.status() == WL_CONNECTED;
+}
+
+// WiFi.begin() with a BSSID keeps the station on that access point, also for auto reconnect. Drop it
+// from the station settings once connected so a reconnect can move to another access point of a mesh.
+// The settings are only used for the next connection, the current one is kept.
+void unpinWiFiAccessPoint() {
+  wifi_config_t config;
+  if (esp_wifi_get_config(WIFI_IF_STA, &config) != ESP_OK) {
+    return;
+  }
+  config.sta.bssid_set = false;
+  esp_wifi_set_config(WIFI_IF_STA, &config);
+}
+
+// Connect straight to the access point of the last connection without scanning for the network. The
+// address always comes from DHCP or the static IP settings. Returns false if that did not work, WiFi
+// Manager then connects as usual.
+bool wifiFastConnect(bool staticIp) {
+  cydWeeWXWiFiAccessPoint accessPoint = {};
+  cydWeeWXPreference.begin(CYD_WWX_PREFERENCES_NAMESPACE, CYD_WWX_PREFERENCES_RO);
+  size_t length = cydWeeWXPreference.getBytes(CYD_WWX_PREF_KEY_WIFI_AP, &accessPoint, sizeof(accessPoint));
+  cydWeeWXPreference.end();
+  String ssid = wm.getWiFiSSID();
+  if ((length != sizeof(accessPoint)) || ssid.isEmpty() || !ssid.equals(accessPoint.ssid)) {
+    LOG_INFO("wifiFastConnect", "No access point saved for the WiFi network.");
+    return false;
+  }
+  WiFi.setHostname(cydWeeWXHostname.c_str());
+  WiFi.setAutoReconnect(true);
+
+  uint32_t connectStart = millis();
+  WiFi.begin(ssid.c_str(), wm.getWiFiPass().c_str(), accessPoint.channel, accessPoint.bssid);
+  if (waitForWiFi(connectStart)) {
+    LOG_INFO("wifiFastConnect", "WiFi connected to the saved access point in " << (millis() - connectStart) << " msec (channel "
+      << accessPoint.channel << ", " << (staticIp ? "static IP" : "DHCP") << ").");
+    unpinWiFiAccessPoint();
+    return true;
+  }
+
+  // The access point may be gone or moved, so let the station pick any access point of the network
+  LOG_INFO("wifiFastConnect", "Saved access point did not connect, trying any access point of the network.");
+  WiFi.disconnect();
+  connectStart = millis();
+  WiFi.begin(ssid.c_str(), wm.getWiFiPass().c_str());
+  if (waitForWiFi(connectStart)) {
+    LOG_INFO("wifiFastConnect", "WiFi connected in " << (millis() - connectStart) << " msec.");
+    return true;
+  }
+
+  LOG_INFO("wifiFastConnect", "WiFi did not connect, using WiFi Manager.");
+  WiFi.disconnect();
+  return false;
+}
+
+// Save the access point of the current connection for wifiFastConnect()
+void saveWiFiFastConnect() {
+  if (!WiFi.isConnected()) {
+    return;
+  }
+  cydWeeWXWiFiAccessPoint accessPoint = {};
+  strlcpy(accessPoint.ssid, WiFi.SSID().c_str(), sizeof(accessPoint.ssid));
+  memcpy(accessPoint.bssid, WiFi.BSSID(), sizeof(accessPoint.bssid));
+  accessPoint.channel = WiFi.channel();
+
+  // Only write to flash when the access point changed
+  cydWeeWXWiFiAccessPoint savedAccessPoint = {};
+  cydWeeWXPreference.begin(CYD_WWX_PREFERENCES_NAMESPACE, CYD_WWX_PREFERENCES_RW);
+  if ((cydWeeWXPreference.getBytes(CYD_WWX_PREF_KEY_WIFI_AP, &savedAccessPoint, sizeof(savedAccessPoint)) != sizeof(savedAccessPoint))
+      || (memcmp(&savedAccessPoint, &accessPoint, sizeof(accessPoint)) != 0)) {
+    cydWeeWXPreference.putBytes(CYD_WWX_PREF_KEY_WIFI_AP, &accessPoint, sizeof(accessPoint));
+    LOG_INFO("saveWiFiFastConnect", "Saved access point " << WiFi.BSSIDstr() << " on channel " << accessPoint.channel << ".");
+  }
+  cydWeeWXPreference.end();
+}
+#endif  // CYD_WWX_WIFI_FAST_CONNECT
+
 // Call back from Configuration portal when SAVE button is clicked for setting the WeeWX server URL
 void saveCydWeeWxConfigCB() {
   
@@ -1986,16 +3226,59 @@ void setup() {
   // Set up Task Scheduler
   cydScheduler.init();
   cydScheduler.addTask(tLvglHandler);
-  cydScheduler.addTask(tWeeWXUpdate);
-  cydScheduler.addTask(tOpenMeteoUpdate);
+  cydScheduler.addTask(tWeatherSnapshotPickup);
   cydScheduler.addTask(tCydWeeWXTriggerPin);
   cydScheduler.addTask(tProcessWifiManager);
   cydScheduler.addTask(tTimerWifiManager);
-  cydScheduler.addTask(tTimerErrorState);
   
   // Load parameters from Preferences (WeeWX URL, Backlight configuration, etc.)
   loadCydWeeWXConfig();
 
+  // Build the WeeWX JSON field filter once
+  buildWeeWXFilter(weeWXFilter);
+
+  // TLS settings for the Open-Meteo https queries
+  const char *openMeteoCaPem = nullptr;
+  const int *openMeteoCiphers = nullptr;
+  bool openMeteoResume = false;
+#ifdef CYD_WWX_OPEN_METEO_CA_PEM
+  openMeteoCaPem = CYD_WWX_OPEN_METEO_CA_PEM;
+#endif  // CYD_WWX_OPEN_METEO_CA_PEM
+#ifdef CYD_WWX_OPEN_METEO_TLS_LEAN_CIPHERS
+  openMeteoCiphers = openMeteoCipherSuites;
+#endif  // CYD_WWX_OPEN_METEO_TLS_LEAN_CIPHERS
+#ifdef CYD_WWX_OPEN_METEO_TLS_RESUME
+  openMeteoResume = true;
+#endif  // CYD_WWX_OPEN_METEO_TLS_RESUME
+  openMeteoFetch.setTlsProfile(openMeteoCaPem, openMeteoCiphers, openMeteoResume);
+#ifdef CYD_WWX_WEEWX_RESOLVER_CACHE
+  weeWXFetch.setResolver(&weeWXResolver);
+#endif  // CYD_WWX_WEEWX_RESOLVER_CACHE
+#ifdef CYD_WWX_WEEWX_GZIP
+  weeWXFetch.setGzip(&weeWXInflater);
+#endif  // CYD_WWX_WEEWX_GZIP
+#ifdef CYD_WWX_RUN_ON_WOKWI
+  weeWXFetch.setTransport(&weeWXFixture);
+  openMeteoFetch.setTransport(&openMeteoFixture);
+#endif  // CYD_WWX_RUN_ON_WOKWI
+#ifdef CYD_WWX_FAULT_INJECTION
+  for (cydWeeWXFaultTransport *faults : {&weeWXFaults, &openMeteoFaults}) {
+    faults->latency = CYD_WWX_FAULT_LATENCY;
+    faults->readLimit = CYD_WWX_FAULT_READ_LIMIT;
+    faults->truncateAfter = CYD_WWX_FAULT_TRUNCATE_AFTER;
+    faults->errorAfter = CYD_WWX_FAULT_ERROR_AFTER;
+    faults->statusCode = CYD_WWX_FAULT_STATUS_CODE;
+  }
+  openMeteoNetworkTransport.setTlsProfile(openMeteoCaPem, openMeteoCiphers, openMeteoResume);
+  weeWXFetch.setTransport(&weeWXFaults);
+  openMeteoFetch.setTransport(&openMeteoFaults);
+  LOG_INFO("setup", "Fault injection on. Latency: " << CYD_WWX_FAULT_LATENCY << " msec, status code: " << CYD_WWX_FAULT_STATUS_CODE << ".");
+#endif  // CYD_WWX_FAULT_INJECTION
+
+  // Start the network task on the other core. It stays idle until the main display enables polling.
+  xTaskCreatePinnedToCore(cydWeeWXNetworkTask, "cydWeeWXNetwork", CYD_WWX_NETWORK_TASK_STACK_SIZE, NULL,
+                          CYD_WWX_NETWORK_TASK_PRIORITY, &networkTaskHandle, CYD_WWX_NETWORK_TASK_CORE);
+
   // Configure Backlight if appropriate
   #ifndef TFT_BL  // Comment out #define TFT_BL in User_Setup.h to set backlight here
   pinMode(CYD_WWX_BL_PIN, OUTPUT);
@@ -2021,6 +3304,9 @@ void setup() {
   // Set up WiFi Manager
   pinMode(cydWeeWXTriggerPin, INPUT_PULLUP);  // Pin to detect to activate WiFi Manager Portal
 
+#ifdef CYD_WWX_WIFI_EVENTS
+  WiFi.onEvent(wifiEventCB);  // Before connecting so the first connection is seen
+#endif  // CYD_WWX_WIFI_EVENTS
   WiFi.mode(WIFI_STA); // explicitly set mode, esp defaults to STA+AP  
 
   #ifdef CYD_WWX_RUN_ON_WOKWI
@@ -2031,6 +3317,10 @@ void setup() {
   
   wmWeeWXUrl = new WiFiManagerParameter("URL", "WeeWX URL", cydWeeWXUrl.c_str(), CYD_WWX_STRING_FIELD_LENGTH);
   wmCydWeeWXHostname = new WiFiManagerParameter("HOSTNAME", "cydWeeWX Hostname", cydWeeWXHostname.c_str(), CYD_WWX_STRING_FIELD_LENGTH);
+  wmStaticIp = new WiFiManagerParameter("STATICIP", "Static IP (blank for DHCP)", cydWeeWXStaticIp.c_str(), CYD_WWX_IP_FIELD_LENGTH);
+  wmStaticGateway = new WiFiManagerParameter("STATICGATEWAY", "Static IP Gateway", cydWeeWXStaticGateway.c_str(), CYD_WWX_IP_FIELD_LENGTH);
+  wmStaticSubnet = new WiFiManagerParameter("STATICSUBNET", "Static IP Subnet Mask", cydWeeWXStaticSubnet.c_str(), CYD_WWX_IP_FIELD_LENGTH);
+  wmStaticDns = new WiFiManagerParameter("STATICDNS", "Static IP DNS Server", cydWeeWXStaticDns.c_str(), CYD_WWX_IP_FIELD_LENGTH);
   screenMaxBrightness = new WiFiManagerParameter(screenMaxBrightnessHtml);
   screenMaxBrightnessHidden = new WiFiManagerParameter("MAXBRIGHTNESSHIDDEN", "", String(cydWeeWXBlMax).c_str(), 10, WFM_NO_LABEL);
   screenDimBrightness = new WiFiManagerParameter(screenDimBrightnessHtml);
@@ -2054,6 +3344,10 @@ void setup() {
   wm.setCustomHeadElement(customWmHeaderHtml);
   wm.addParameter(wmWeeWXUrl);
   wm.addParameter(wmCydWeeWXHostname);
+  wm.addParameter(wmStaticIp);
+  wm.addParameter(wmStaticGateway);
+  wm.addParameter(wmStaticSubnet);
+  wm.addParameter(wmStaticDns);
   wm.addParameter(screenMaxBrightness);
   wm.addParameter(screenMaxBrightnessHidden);
   wm.addParameter(screenDimBrightness);
@@ -2095,10 +3389,20 @@ void setup() {
 
   LOG_INFO("setup", "Starting WiFi Manager AP: " << CYD_WWX_WM_AP_NAME << " Password: " << cydWeeWXPassword);
 
+  bool staticIp = applyStaticIp();
+  bool wifiConnected = false;
+#if defined(CYD_WWX_WIFI_FAST_CONNECT) && !defined(CYD_WWX_RUN_ON_WOKWI)
+  wifiConnected = wifiFastConnect(staticIp);
+#endif  // CYD_WWX_WIFI_FAST_CONNECT && !CYD_WWX_RUN_ON_WOKWI
+
   // WM in nonblocking mode so checking return status has limited value
-  if(wm.autoConnect(cydWeeWXHostname.c_str(), cydWeeWXPassword.c_str())) {  
-    LOG_INFO("setup", "WiFi Connected");
+  uint32_t wifiConnectStart = millis();
+  if(!wifiConnected && wm.autoConnect(cydWeeWXHostname.c_str(), cydWeeWXPassword.c_str())) {  
+    LOG_INFO("setup", "WiFi Connected by WiFi Manager in " << (millis() - wifiConnectStart) << " msec.");
   }
+#ifdef CYD_WWX_WIFI_FAST_CONNECT
+  saveWiFiFastConnect();
+#endif  // CYD_WWX_WIFI_FAST_CONNECT
 
  
 
@@ -2125,6 +3429,11 @@ void setup() {
 // Main loop that only calls the Task Scheduler 
 void loop() {
   // Only need task scheduler in the loop
+  int64_t passStart = esp_timer_get_time();
   cydScheduler.execute();
+  int32_t passTime = (int32_t)(esp_timer_get_time() - passStart);
+  if (passTime > loopMaxPassTime.load(std::memory_order_relaxed)) {
+    loopMaxPassTime.store(passTime, std::memory_order_relaxed);
+  }
 
 }
\ No newline at end of file
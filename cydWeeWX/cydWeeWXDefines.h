@@ -18,6 +18,11 @@
 #define CYD_WWX_WM_TRIGGER_PIN 0                    // Trigger pin to enter/leave Configuration Portal mode (BOOT pin on CYD)
 #define CYD_WWX_WM_TIMEOUT 300                      // Configuration Portal timeout in seconds (5 minutes)
 #define CYD_WWX_WM_TRIGGER_PIN_HOLD_COUNT 20        // Pin must be held down this value times CYD_WWX_CHECK_WM_TRIGGER_PIN_EVERY in msec
+#define CYD_WWX_WIFI_FAST_CONNECT                   // Comment out to always connect through WiFi Manager with a full scan
+#define CYD_WWX_WIFI_FAST_CONNECT_TIMEOUT 5000      // Give up on the last access point, then on the network, after this long each (msec)
+#define CYD_WWX_IP_FIELD_LENGTH 16                  // Configuration Portal field length for IP addresses
+#define CYD_WWX_WIFI_EVENTS                         // Pause queries while WiFi is down and query at once when it is back
+#define CYD_WWX_WIFI_OUTAGE_REBOOT_AFTER 600000     // Reboot if WiFi has not come back after this long (msec)
 
 // **************************************************************************************************
 // LVGL Display items
@@ -91,20 +96,88 @@
 // Task Scheduler related items
 // **************************************************************************************************
 #define CYD_WWX_GET_WEEWX_UPDATE_EVERY 120000       // Query WeeWX Server every 2 minutes (msec)
-#define CYD_WWX_GET_OPENMETEO_UPDATE_EVERY 300000   // 5 minutes (msec) - Open-meteo data updates every 15 mins. Stay less than 10,000 calls per day.
+#define CYD_WWX_GET_OPENMETEO_UPDATE_EVERY 300000   // 5 minutes (msec) - Used until the time is known from WeeWX. Stay less than 10,000 calls per day.
 #define CYD_WWX_CALL_LVGL_HANDLER_EVERY 5           // Refresh LVGL display every 5 msec
 #define CYD_WWX_CHECK_WM_TRIGGER_PIN_EVERY 100      // Check trigger pin every 100 msec
 #define CYD_WWX_PROCESS_WM_EVERY 10                 // process Configuration Portal activity every 10 msec
 #define CYD_WWX_BL_LDR_TIMER 5000                   // check LDR and set backlight brightness. (msec)
 #define CYD_WWX_ONE_SECOND_TIMER 1000               // One second task timer (msec) - DO NOT CHANGE 
+#define CYD_WWX_SNAPSHOT_PICKUP_EVERY 100           // Check for new weather data from the network task every 100 msec
+
+// **************************************************************************************************
+// Network task. Runs the WeeWX and Open-Meteo queries on the core that is not running loop().
+// **************************************************************************************************
+#define CYD_WWX_NETWORK_TASK_STACK_SIZE 12288       // Stack for the network task (bytes). JSON parsing and TLS need plenty.
+#define CYD_WWX_NETWORK_TASK_PRIORITY 1             // Same priority as loop()
+#define CYD_WWX_NETWORK_TASK_CORE 0                 // loop() runs on core 1
+#define CYD_WWX_NETWORK_TASK_DELAY 1                // Advance a running WeeWX or Open-Meteo query every 1 msec
 
 // **************************************************************************************************
 // urls for data retrieval
 // **************************************************************************************************
-#define CYD_WWX_OPEN_METEO_URL "https://api.open-meteo.com/v1/forecast?latitude=%s&longitude=%s&current=weather_code"  // Open-Meteo URL (DO NOT CHANGE)
+#define CYD_WWX_OPEN_METEO_URL "https://api.open-meteo.com/v1/forecast?latitude=%s&longitude=%s&current=weather_code&hourly=weather_code&forecast_hours=%d&timeformat=unixtime"  // Open-Meteo URL (DO NOT CHANGE)
 #define CYD_WWX_WEEWX_URL "http://yourWeeWx.server.local/"  // This ia an example. May be changed here or through the Management Portal
-#define CYD_WWX_WEEWX_JSON_DATA_FILE "cyd_weewx.json"       // WeeWX JSON file name - DO NOT CHANGE
+#define CYD_WWX_WEEWX_JSON_DATA_FILE "cyd_weewx.json"       // WeeWX data file name. "cyd_weewx_compact.json" or "cyd_weewx_compact.msgpack" for the compact feed
 #define CYD_WWX_STRING_FIELD_LENGTH 128                   // Configuration Portal field length for buffers
+#define CYD_WWX_WEEWX_FILTER_FIELDS                       // Comment out to keep every WeeWX JSON field in the parsed document
+#define CYD_WWX_WEEWX_CONDITIONAL_GET                     // Comment out to always transfer the WeeWX file instead of using ETag/If-Modified-Since
+#define CYD_WWX_WEEWX_HASH_DEDUPE                         // Comment out to parse every WeeWX response even if identical to the last one
+#define CYD_WWX_WEEWX_BODY_BUFFER_SIZE 20480              // Static buffer for the WeeWX response
+#define CYD_WWX_OPEN_METEO_BODY_BUFFER_SIZE 4096          // Static buffer for the Open-Meteo response
+#define CYD_WWX_JSON_ARENA                                // Comment out to allocate the WeeWX and Open-Meteo JsonDocuments from the heap
+#define CYD_WWX_JSON_ARENA_SIZE 8192                      // Static buffer for the JsonDocument of a query, at least 1.5x the peak from test/measureJsonArena.cpp. Larger documents spill over to the heap.
+#define CYD_WWX_ARENA_HEADER 8                            // Arena block size header and alignment (bytes) - DO NOT CHANGE
+#define CYD_WWX_OPEN_METEO_FORECAST_HOURS 24              // Hourly weather codes cached from each Open-Meteo query
+#define CYD_WWX_OPEN_METEO_REFRESH_INTERVALS 1            // Query Open-Meteo after this many of its current weather intervals (15 min each)
+#define CYD_WWX_OPEN_METEO_REFRESH_MARGIN 60000           // Query this long after new Open-Meteo data is expected (msec)
+#define CYD_WWX_OPEN_METEO_TLS_RESUME                     // Comment out to do a full TLS handshake for every Open-Meteo query
+#define CYD_WWX_OPEN_METEO_TLS_LEAN_CIPHERS               // Comment out to offer every mbedTLS cipher suite to Open-Meteo
+//#define CYD_WWX_OPEN_METEO_CA_PEM "-----BEGIN CERTIFICATE-----\n...\n-----END CERTIFICATE-----\n"  // Uncomment to trust only this CA instead of the certificate bundle
+#define CYD_WWX_WMO_STATION_FALLBACK                      // Comment out to keep the last Open-Meteo weather code when Open-Meteo cannot be reached
+//#define CYD_WWX_WMO_STATION_ONLY                        // Uncomment to infer the weather code from the station readings and never query Open-Meteo
+#define CYD_WWX_WEEWX_GZIP                                // Comment out to not ask the WeeWX server for gzip encoded responses. Saves the 10992 byte inflater.
+#define CYD_WWX_WEEWX_KEEP_ALIVE                          // Comment out to open a new WeeWX server connection for every poll
+#define CYD_WWX_WEEWX_RESOLVER_CACHE                      // Comment out to look up the WeeWX server address for every new connection
+#define CYD_WWX_RESOLVER_CACHE_SIZE 4                     // Host addresses kept
+#define CYD_WWX_RESOLVER_TTL 600000                       // Look a cached address up again after this long (msec)
+#define CYD_WWX_RESOLVER_NEGATIVE_TTL 30000               // Wait this long before retrying a failed lookup (msec)
+#define CYD_WWX_WEEWX_ADAPTIVE_POLL                       // Comment out to query WeeWX at a fixed interval instead of just after each report
+#define CYD_WWX_ADAPTIVE_POLL_MATCHES 2                   // Report period must be seen this many times in a row before it is used
+#define CYD_WWX_ADAPTIVE_POLL_MARGIN 5000                 // Query this long after a report is expected (msec)
+#define CYD_WWX_ADAPTIVE_POLL_RETRY 15000                 // Query again after this long if the expected report has not arrived (msec)
+#define CYD_WWX_HTTP_CONNECT_TIMEOUT 10000                // Give up connecting to a server after this long (msec)
+#define CYD_WWX_HTTP_READ_TIMEOUT 5000                    // Give up reading a response after this long without data (msec)
+#define CYD_WWX_FETCH_SLICE_BYTES 1024                    // Most response bytes read in one query step
+#define CYD_WWX_FETCH_SELECT_TIMEOUT 1                    // Longest wait for a socket in one query step (msec)
+#define CYD_WWX_FETCH_HEADER_LINE_LENGTH 256              // Longer HTTP response header lines are truncated
+#define CYD_WWX_FETCH_HOST_LENGTH 128                     // Longest server host name in a URL, including the terminating null
+#define CYD_WWX_FETCH_REQUEST_LENGTH 640                  // Longest HTTP request, with the URL path and the extra headers
+#define CYD_WWX_FETCH_VALIDATOR_LENGTH 96                 // Longest ETag or Last-Modified value kept for the next conditional GET
+#define CYD_WWX_HTTP_CODE_OK 200                          // HTTP status for a good response - DO NOT CHANGE
+#define CYD_WWX_HTTP_CODE_NOT_MODIFIED 304                // HTTP status for an unchanged conditional GET - DO NOT CHANGE
+//#define CYD_WWX_FAULT_INJECTION                         // Uncomment to add the faults below to the WeeWX and Open-Meteo queries, for testing
+#define CYD_WWX_FAULT_LATENCY 0                           // Extra time to connect and to the first response byte (msec)
+#define CYD_WWX_FAULT_READ_LIMIT 0                        // Most response bytes passed on in one query step, 0 for no limit
+#define CYD_WWX_FAULT_TRUNCATE_AFTER SIZE_MAX             // Close the connection after this many response bytes
+#define CYD_WWX_FAULT_ERROR_AFTER SIZE_MAX                // Fail the connection after this many response bytes
+#define CYD_WWX_FAULT_STATUS_CODE 0                       // Reply with this HTTP status instead of the server's response, 0 for the real response
+#define CYD_WWX_FNV1A_OFFSET_BASIS 2166136261UL           // FNV-1a 32 bit hash offset basis - DO NOT CHANGE
+#define CYD_WWX_FNV1A_PRIME 16777619UL                    // FNV-1a 32 bit hash prime - DO NOT CHANGE
+
+// **************************************************************************************************
+// MQTT push updates. Needs the PubSubClient library and the weewx-mqtt extension on the WeeWX server.
+// **************************************************************************************************
+//#define CYD_WWX_MQTT                                    // Uncomment to show WeeWX loop packets from an MQTT broker as they arrive
+#define CYD_WWX_MQTT_BROKER "yourMqtt.server.local"       // MQTT broker host name or IP address
+#define CYD_WWX_MQTT_PORT 1883                            // MQTT broker port
+#define CYD_WWX_MQTT_USER ""                              // MQTT user name, leave blank if the broker does not need one
+#define CYD_WWX_MQTT_PASSWORD ""                          // MQTT password
+#define CYD_WWX_MQTT_TOPIC "weather/loop"                 // weewx-mqtt aggregate topic, or "weather/#" for one topic per value
+#define CYD_WWX_MQTT_BUFFER_SIZE 2048                     // Largest MQTT message (bytes)
+#define CYD_WWX_MQTT_RECONNECT_EVERY 30000                // Wait between broker connection attempts (msec)
+#define CYD_WWX_MQTT_SOCKET_TIMEOUT 2                     // Give up waiting for the broker to answer after this long (seconds)
+#define CYD_WWX_MQTT_REPAINT_EVERY 2000                   // Combine MQTT updates so the display is repainted at most this often (msec)
+#define CYD_WWX_MQTT_GET_WEEWX_UPDATE_EVERY 300000        // Query WeeWX Server for trends and almanac every 5 minutes (msec)
 
 // **************************************************************************************************
 // Message template strings - DO NOT CHANGE
@@ -129,6 +202,13 @@
 #define CYD_WWX_PREF_KEY_LDR_HIGH_THRESHOLD "HI_TH"    // Preferences Key name for LDR high threshold
 #define CYD_WWX_PREF_KEY_MAX_BRIGHTNESS "MAX_BL"    // Preferences Key name for max brightness
 #define CYD_WWX_PREF_KEY_MIN_BRIGHTNESS "MIN_BL"    // Preferences Key name for dim brightness
+#define CYD_WWX_PREF_KEY_STATIC_IP "STA_IP"         // Preferences Key name for the static IP address, blank for DHCP
+#define CYD_WWX_PREF_KEY_STATIC_GATEWAY "STA_GW"    // Preferences Key name for the static IP gateway
+#define CYD_WWX_PREF_KEY_STATIC_SUBNET "STA_MASK"   // Preferences Key name for the static IP subnet mask
+#define CYD_WWX_PREF_KEY_STATIC_DNS "STA_DNS"       // Preferences Key name for the static IP DNS server
+#define CYD_WWX_PREF_KEY_WIFI_AP "WIFI_AP"          // Preferences Key name for the access point of the last WiFi connection
+#define CYD_WWX_PREF_KEY_LATITUDE "STN_LAT"         // Preferences Key name for the last station latitude
+#define CYD_WWX_PREF_KEY_LONGITUDE "STN_LON"        // Preferences Key name for the last station longitude
 #define CYD_WWX_PREFERENCES_RW false                // Open Preferences Read/Write
 #define CYD_WWX_PREFERENCES_RO true                 // Open Preferences Read Only
 
@@ -137,8 +217,9 @@
 // Both a failed WiFi connection and WeeWX query are considered critical since no weather data can
 // be shown. An Open-Meteo failure only impacts display of the weather icon and description so not
 // critical.
-// A Critical error will also have a reboot timer of CYD_WWX_ERROR_WAIT_TO_REBOOT minutes hoping to 
-// clear the error.
+// A Critical error starts the recovery ladder. Failed WeeWX queries are retried with a growing backoff.
+// Only failures on this side (no IP address, name lookup or connect failed) go on to a WiFi reset and,
+// as the last resort, a reboot. An HTTP error or bad data from the server is only retried.
 // **************************************************************************************************
 #define CYD_WWX_NO_ERROR 0
 #define CYD_WWX_NON_CRITICAL_ERROR 1
@@ -148,7 +229,22 @@
 #define CYD_WWX_OPEN_METEO_QUERY_ERROR CYD_WWX_NON_CRITICAL_ERROR
 
 #define CYD_WWX_ERROR_STATE_CODE 1000               // Forces WMO Icon to error icon
-#define CYD_WWX_ERROR_WAIT_TO_REBOOT 300            // wait until reboot when in error state - in seconds
+#define CYD_WWX_LOADING_STATE_CODE 1001             // WMO Icon shown until the first weather code arrives
+#define CYD_WWX_PLACEHOLDER_READING "--"            // Shown for readings until the first WeeWX data arrives
+#define CYD_WWX_PLACEHOLDER_HEADER "Waiting for WeeWX data..."  // Shown in the header until the first WeeWX data arrives
+#define CYD_WWX_READING_TEXT_LENGTH 12              // Longest reading text shown, including the terminating null
+#define CYD_WWX_UNITS_TEXT_LENGTH 12                // Longest units text shown
+#define CYD_WWX_ICON_TEXT_LENGTH 8                  // Longest icon font character, UTF-8 encoded
+#define CYD_WWX_TIME_TEXT_LENGTH 12                 // Longest almanac time shown
+#define CYD_WWX_MOON_PHASE_TEXT_LENGTH 32           // Longest moon phase description shown
+#define CYD_WWX_LOCATION_TEXT_LENGTH 64             // Longest station location shown
+#define CYD_WWX_COORDINATE_TEXT_LENGTH 16           // Longest latitude or longitude shown
+#define CYD_WWX_HEADER_TEXT_LENGTH 160              // Longest screen header shown
+#define CYD_WWX_ERROR_TEXT_LENGTH 96                // Longest error message shown
+#define CYD_WWX_RECOVERY_BACKOFF_BASE 5000          // First retry after a failed WeeWX query (msec), doubled for each failure
+#define CYD_WWX_RECOVERY_BACKOFF_MAX 120000         // Longest wait between retries (msec)
+#define CYD_WWX_RECOVERY_WIFI_RESET_AFTER 4         // Reset WiFi after this many WeeWX queries in a row could not reach the server
+#define CYD_WWX_RECOVERY_REBOOT_AFTER 1800000       // Reboot if WeeWX queries could not reach the server for this long (msec)
 
 // **************************************************************************************************
 // To run on the Wokwi simulator
@@ -171,28 +267,6 @@
 //#define CYD_WEEWX_ENABLE_DEBUG_LOG                // Comment out to disable Debug logging
 #define CYD_WEEWX_ENABLE_INFO_LOG                   // Comment out to disable Information logging
 #define CYD_WEEWX_ENABLE_ERROR_LOG                  // Comment out to disable Error logging
-#if defined CYD_WEEWX_ENABLE_DEBUG_LOG || defined CYD_WEEWX_ENABLE_DEBUG_LOG || defined CYD_WEEWX_ENABLE_ERROR_LOG
-template <class T>
-inline Print &operator<<(Print &obj, T arg)
-{
-    obj.print(arg);
-    return obj;
-}
-#endif  // CYD_WEEWX_ENABLE_DEBUG_LOG || CYD_WEEWX_ENABLE_INFO_LOG || CYD_WEEWX_ENABLE_ERROR_LOG
-#ifdef CYD_WEEWX_ENABLE_DEBUG_LOG
-#define LOG_DEBUG(svc, content) CYD_WEEWX_LOG_OUTPUT << "DEBUG: <" << svc << "> " << content << "\r\n"
-#else
-#define LOG_DEBUG(svc, content) 
-#endif  // CYD_WEEWX_ENABLE_DEBUG_LOG
-#ifdef CYD_WEEWX_ENABLE_INFO_LOG
-#define LOG_INFO(svc, content) CYD_WEEWX_LOG_OUTPUT << "INFO: <" << svc << "> " << content << "\r\n"
-#else
-#define LOG_INFO(svc, content) 
-#endif  // CYD_WEEWX_ENABLE_INFO_LOG
-#ifdef CYD_WEEWX_ENABLE_ERROR_LOG
-#define LOG_ERROR(svc, content) CYD_WEEWX_LOG_OUTPUT << "ERROR: <" << svc << "> " << content << "\r\n"
-#else
-#define LOG_ERROR(svc, content) 
-#endif  // CYD_WEEWX_ENABLE_ERROR_LOG
+#include "cydWeeWXLog.h"
 
 #endif // CYD_WEEWX_DEFINES
\ No newline at end of file
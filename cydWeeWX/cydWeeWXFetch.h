@@ -0,0 +1,740 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the incremental HTTP GET state machine
+// ** A fetch is started with begin() and then advanced with step(). Each step does a
+// ** bounded amount of work so the LVGL handler and other tasks keep running while a
+// ** query is in progress. The connection itself is made through a transport, see
+// ** cydWeeWXTransport.h.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_FETCH
+#define CYD_WEEWX_FETCH
+
+#include <Arduino.h>
+#include "cydWeeWXLog.h"
+#include "cydWeeWXPlatform.h"
+#include "cydWeeWXResolver.h"
+#include "cydWeeWXTransport.h"
+
+enum class cydwwxfetchstate {
+  IDLE = 0,
+  CONNECTING,
+  SENDING,
+  READING_HEADERS,
+  READING_BODY,
+  DONE,
+  FAILED
+};
+
+enum class cydwwxbodymode {
+  LENGTH = 0,     // Content-Length given
+  CHUNKED,        // Transfer-Encoding: chunked
+  UNTIL_CLOSE     // Body ends when the server closes the connection
+};
+
+enum class cydwwxchunkstate {
+  SIZE = 0,
+  DATA,
+  DATA_END,
+  TRAILER
+};
+
+// Position in a gzip encoded body. The header fields after HEADER are optional.
+enum class cydwwxgzipstate {
+  HEADER = 0,     // Fixed 10 byte header
+  EXTRA_LENGTH,
+  EXTRA,
+  NAME,
+  COMMENT,
+  HEADER_CRC,
+  DEFLATE,        // Compressed data
+  TRAILER         // CRC and length of the inflated data, not checked
+};
+
+// FNV-1a hash of a block of data, continuing from a previous hash value
+inline uint32_t fnv1aHash(uint32_t hash, const uint8_t *data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    hash ^= data[i];
+    hash *= CYD_WWX_FNV1A_PRIME;
+  }
+  return hash;
+}
+
+static const char *const cydWeeWXFetchStateNames[] = {"idle", "connecting", "sending", "reading headers", "reading body", "done", "failed"};
+
+class cydWeeWXFetch {
+  public:
+    int statusCode = 0;                     // HTTP status code, 0 if no response
+    size_t bodyLength = 0;                  // Bytes in the body buffer, which is always null terminated
+    uint32_t bodyHash = CYD_WWX_FNV1A_OFFSET_BASIS;  // FNV-1a hash of the body, worked out slice by slice as it arrives
+    char eTag[CYD_WWX_FETCH_VALIDATOR_LENGTH] = "";          // ETag header of the response, empty if none or too long
+    char lastModified[CYD_WWX_FETCH_VALIDATOR_LENGTH] = "";  // Last-Modified header of the response, empty if none or too long
+    const char *errorMessage = "";          // Reason for a FAILED fetch
+    cydwwxfetchstate failedState = cydwwxfetchstate::IDLE;  // State a FAILED fetch stopped in
+    bool connectionReused = false;          // Request went out on a connection kept from the last fetch
+    uint32_t stepCount = 0;                 // Number of step() calls for the fetch
+    int32_t maxStepTime = 0;                // Longest step() call in usec
+    cydwwxfetchstate maxStepState = cydwwxfetchstate::IDLE;  // State the longest step() call started in
+    int64_t startTime = 0;                  // cydWeeWXMicros() time when begin() was called
+    int32_t resolveTime = 0;                // Time to get the server address from the resolver in usec. 0 if not used.
+    int32_t connectTime = 0;                // Time to connect, including any TLS handshake, in msec. 0 if the connection was reused.
+    bool sessionOffered = false;            // A saved TLS session was offered to the server to skip the full handshake
+    uint32_t heapAtStart = 0;               // Free heap when begin() was called
+    uint32_t minFreeHeap = 0;               // Lowest free heap seen during the fetch
+    bool gzipped = false;                   // Body was sent gzip encoded and inflated into the body buffer
+    size_t encodedLength = 0;               // Body bytes as sent by the server, before any inflating
+    int32_t inflateTime = 0;                // Time spent inflating the body in usec
+
+    cydWeeWXFetch(const char *name, char *body, size_t bodySize) : name(name), body(body), bodySize(bodySize) {}
+
+#ifdef ESP_PLATFORM
+    // Settings for https connections, see cydWeeWXTlsTransport::setTlsProfile()
+    void setTlsProfile(const char *caPem, const int *cipherSuites, bool resumeSessions) {
+      tlsTransport.setTlsProfile(caPem, cipherSuites, resumeSessions);
+    }
+#endif  // ESP_PLATFORM
+
+    // Send requests and read responses through transport instead of the network, for example to replay
+    // a recorded response or add faults. nullptr goes back to the network. Off the ESP32 there is no
+    // network, so a transport must be set before the first fetch.
+    void setTransport(cydWeeWXTransport *transport) {
+      dropConnection();
+#ifdef ESP_PLATFORM
+      this->transport = (transport != nullptr) ? transport : &tlsTransport;
+#else
+      this->transport = transport;
+#endif  // ESP_PLATFORM
+    }
+
+    // Get plain http server addresses from resolver instead of looking them up for every connection.
+    // https servers are always looked up, as the TLS server name check needs the host name.
+    void setResolver(cydWeeWXResolver *resolver) {
+      this->resolver = resolver;
+    }
+
+    // Ask for gzip encoded responses and inflate them with inflater. nullptr asks for unencoded responses.
+    void setGzip(tinfl_decompressor *inflater) {
+      this->inflater = inflater;
+    }
+
+    // Start a GET of url with extraHeaders (each ending in "\r\n") added to the request.
+    // If keepAlive is true the connection is left open for the next fetch of the same server.
+    // The request is built in a fixed buffer, so a fetch makes no heap allocations of its own.
+    bool begin(const char *url, const char *extraHeaders, bool keepAlive) {
+      if (isBusy()) {
+        return false;
+      }
+      bool newSecure;
+      char newHost[CYD_WWX_FETCH_HOST_LENGTH];
+      uint16_t newPort;
+      const char *path;
+      if (!parseUrl(url, newSecure, newHost, newPort, path)) {
+        fail("invalid URL");
+        return false;
+      }
+      if (transport->isOpen() && (!canReuse || (newSecure != secure) || (newPort != port) || (strcmp(newHost, host) != 0))) {
+        dropConnection();
+      }
+      secure = newSecure;
+      strcpy(host, newHost);
+      port = newPort;
+      keepConnection = keepAlive;
+
+      char portText[8] = "";
+      if (port != (secure ? 443 : 80)) {
+        snprintf(portText, sizeof(portText), ":%u", (unsigned int)port);
+      }
+      int length = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: %s%s\r\nUser-Agent: cydWeeWX\r\nAccept: application/json\r\n%s%s%s\r\n",
+                            path, host, portText, (inflater != nullptr) ? "Accept-Encoding: gzip\r\n" : "",
+                            keepConnection ? "Connection: keep-alive\r\n" : "Connection: close\r\n", extraHeaders);
+      if ((length < 0) || ((size_t)length >= sizeof(request))) {
+        fail("request too long");
+        return false;
+      }
+      requestLength = length;
+
+      statusCode = 0;
+      bodyLength = 0;
+      bodyHash = CYD_WWX_FNV1A_OFFSET_BASIS;
+      body[0] = '\0';
+      eTag[0] = '\0';
+      lastModified[0] = '\0';
+      errorMessage = "";
+      failedState = cydwwxfetchstate::IDLE;
+      stepCount = 0;
+      maxStepTime = 0;
+      maxStepState = cydwwxfetchstate::IDLE;
+      startTime = cydWeeWXMicros();
+      resolveTime = 0;
+      connectTime = 0;
+      sessionOffered = false;
+      heapAtStart = cydWeeWXFreeHeap();
+      minFreeHeap = heapAtStart;
+      connectionReused = transport->isOpen();
+      startRequest();
+      return true;
+    }
+
+    // Advance the fetch by one bounded slice of work. Returns true while the fetch is still in progress.
+    bool step() {
+      int64_t stepStart = cydWeeWXMicros();
+      cydwwxfetchstate stepState = state;
+
+      switch (state) {
+        case cydwwxfetchstate::CONNECTING:
+          stepConnect();
+          break;
+        case cydwwxfetchstate::SENDING:
+          stepSend();
+          break;
+        case cydwwxfetchstate::READING_HEADERS:
+        case cydwwxfetchstate::READING_BODY:
+          stepRead();
+          break;
+        default:
+          break;
+      }
+
+      int32_t stepTime = (int32_t)(cydWeeWXMicros() - stepStart);
+      stepCount += 1;
+      uint32_t freeHeap = cydWeeWXFreeHeap();
+      if (freeHeap < minFreeHeap) {
+        minFreeHeap = freeHeap;
+      }
+      if (stepTime > maxStepTime) {
+        maxStepTime = stepTime;
+        maxStepState = stepState;
+      }
+      return isBusy();
+    }
+
+    bool isBusy() {
+      return (state != cydwwxfetchstate::IDLE) && (state != cydwwxfetchstate::DONE) && (state != cydwwxfetchstate::FAILED);
+    }
+
+    bool failed() {
+      return state == cydwwxfetchstate::FAILED;
+    }
+
+    // Drop the connection, for example when the server address may have changed.
+    // A fetch still in progress is abandoned.
+    void close() {
+      if (isBusy()) {
+        errorMessage = "closed";
+        failedState = state;
+        state = cydwwxfetchstate::FAILED;
+      }
+      dropConnection();
+    }
+
+    // Time since begin() in msec
+    uint32_t elapsed() {
+      return (uint32_t)((cydWeeWXMicros() - startTime) / 1000);
+    }
+
+  private:
+    const char *name;
+    char *body;
+    size_t bodySize;
+
+#ifdef ESP_PLATFORM
+    cydWeeWXTlsTransport tlsTransport;
+    cydWeeWXTransport *transport = &tlsTransport;
+#else
+    cydWeeWXTransport *transport = nullptr;
+#endif  // ESP_PLATFORM
+    tinfl_decompressor *inflater = nullptr;
+    cydWeeWXResolver *resolver = nullptr;
+    char connectHost[CYD_WWX_FETCH_HOST_LENGTH] = "";  // Host name or address the connection is made to
+    int64_t connectStart = 0;
+    bool secure = false;
+    char host[CYD_WWX_FETCH_HOST_LENGTH] = "";
+    uint16_t port = 80;
+    bool keepConnection = false;
+    bool canReuse = false;              // Server allows the connection to be used again
+
+    cydwwxfetchstate state = cydwwxfetchstate::IDLE;
+    uint32_t stateTime = 0;             // cydWeeWXMillis() time of the last progress, for timeouts
+    char request[CYD_WWX_FETCH_REQUEST_LENGTH];
+    size_t requestLength = 0;
+    size_t requestSent = 0;
+    size_t bytesReceived = 0;
+
+    char headerLine[CYD_WWX_FETCH_HEADER_LINE_LENGTH];
+    size_t headerLineLength = 0;
+    bool statusLineSeen = false;
+    bool serverKeepAlive = false;
+    int32_t contentLength = -1;
+    cydwwxbodymode bodyMode = cydwwxbodymode::UNTIL_CLOSE;
+    cydwwxchunkstate chunkState = cydwwxchunkstate::SIZE;
+    size_t chunkRemaining = 0;
+    bool chunkSizeDone = false;
+    cydwwxgzipstate gzipState = cydwwxgzipstate::HEADER;
+    uint8_t gzipFlags = 0;
+    size_t gzipCount = 0;               // Bytes of the current gzip header field seen
+    size_t gzipRemaining = 0;           // Bytes of the gzip extra field still to skip
+
+    void dropConnection() {
+      if (transport != nullptr) {
+        transport->close();
+      }
+      canReuse = false;
+    }
+
+    // Split http(s)://host[:port]/path. urlHost holds CYD_WWX_FETCH_HOST_LENGTH characters and path
+    // points into url.
+    bool parseUrl(const char *url, bool &isSecure, char *urlHost, uint16_t &urlPort, const char *&path) {
+      const char *hostStart;
+      if (strncmp(url, "https://", 8) == 0) {
+        isSecure = true;
+        urlPort = 443;
+        hostStart = url + 8;
+      } else if (strncmp(url, "http://", 7) == 0) {
+        isSecure = false;
+        urlPort = 80;
+        hostStart = url + 7;
+      } else {
+        return false;
+      }
+      const char *pathStart = strchr(hostStart, '/');
+      path = (pathStart != nullptr) ? pathStart : "/";
+      size_t hostLength = (pathStart != nullptr) ? (size_t)(pathStart - hostStart) : strlen(hostStart);
+      const char *portStart = (const char *)memchr(hostStart, ':', hostLength);
+      if (portStart != nullptr) {
+        urlPort = (uint16_t)atol(portStart + 1);
+        hostLength = portStart - hostStart;
+      }
+      if ((hostLength == 0) || (hostLength >= CYD_WWX_FETCH_HOST_LENGTH)) {
+        return false;
+      }
+      memcpy(urlHost, hostStart, hostLength);
+      urlHost[hostLength] = '\0';
+      return urlPort != 0;
+    }
+
+    void startRequest() {
+      requestSent = 0;
+      bytesReceived = 0;
+      headerLineLength = 0;
+      statusLineSeen = false;
+      serverKeepAlive = false;
+      contentLength = -1;
+      bodyMode = cydwwxbodymode::UNTIL_CLOSE;
+      gzipped = false;
+      encodedLength = 0;
+      inflateTime = 0;
+      gzipState = cydwwxgzipstate::HEADER;
+      gzipCount = 0;
+      setState(transport->isOpen() ? cydwwxfetchstate::SENDING : cydwwxfetchstate::CONNECTING);
+      connectStart = cydWeeWXMicros();
+    }
+
+    void setState(cydwwxfetchstate newState) {
+      state = newState;
+      stateTime = cydWeeWXMillis();
+    }
+
+    void fail(const char *message) {
+      errorMessage = message;
+      failedState = state;
+      LOG_ERROR("cydWeeWXFetch", name << " fetch failed while " << cydWeeWXFetchStateNames[(int)state] << ": " << message);
+      body[bodyLength] = '\0';
+      dropConnection();
+      state = cydwwxfetchstate::FAILED;
+    }
+
+    // A kept connection may have been closed by the server while idle, so retry once on a new one
+    bool retryOnNewConnection() {
+      if (!connectionReused || (bytesReceived > 0)) {
+        return false;
+      }
+      LOG_INFO("cydWeeWXFetch", name << " kept connection was closed by the server, reconnecting.");
+      dropConnection();
+      connectionReused = false;
+      startRequest();
+      return true;
+    }
+
+    void stepConnect() {
+      if (!transport->isOpen()) {
+        strcpy(connectHost, host);
+        if (!secure && (resolver != nullptr) && transport->needsAddress()) {
+          IPAddress address;
+          int64_t resolveStart = cydWeeWXMicros();
+          bool resolved = resolver->resolve(host, address);
+          resolveTime = (int32_t)(cydWeeWXMicros() - resolveStart);
+          if (!resolved) {
+            fail("name lookup failed");
+            return;
+          }
+          snprintf(connectHost, sizeof(connectHost), "%u.%u.%u.%u", address[0], address[1], address[2], address[3]);
+          connectStart = cydWeeWXMicros();  // Only time the connection itself
+        }
+        if (!transport->open(connectHost, port, secure)) {
+          fail("out of memory");
+          return;
+        }
+        sessionOffered = transport->sessionOffered;
+      }
+
+      int result = transport->connect();
+      if (result == CYD_WWX_TRANSPORT_CONNECTED) {
+        canReuse = false;
+        connectTime = (int32_t)((cydWeeWXMicros() - connectStart) / 1000);
+        setState(cydwwxfetchstate::SENDING);
+      } else if (result == CYD_WWX_TRANSPORT_CONNECT_FAILED) {
+        expireAddress();
+        fail("connect failed");
+      } else if (cydWeeWXMillis() - stateTime > CYD_WWX_HTTP_CONNECT_TIMEOUT) {
+        expireAddress();
+        fail("connect timed out");
+      }
+    }
+
+    // The server may have a new address, so look it up again for the next connection
+    void expireAddress() {
+      if (!secure && (resolver != nullptr)) {
+        resolver->expire(host);
+      }
+    }
+
+    void stepSend() {
+      ssize_t sent = transport->write(request + requestSent, requestLength - requestSent);
+      if (sent > 0) {
+        requestSent += sent;
+        stateTime = cydWeeWXMillis();
+        if (requestSent >= requestLength) {
+          setState(cydwwxfetchstate::READING_HEADERS);
+        }
+      } else if (sent != CYD_WWX_TRANSPORT_WOULD_BLOCK) {
+        if (!retryOnNewConnection()) {
+          fail("send failed");
+        }
+      } else if (cydWeeWXMillis() - stateTime > CYD_WWX_HTTP_READ_TIMEOUT) {
+        fail("send timed out");
+      }
+    }
+
+    void stepRead() {
+      uint8_t slice[CYD_WWX_FETCH_SLICE_BYTES];
+      ssize_t count = transport->read(slice, sizeof(slice));
+      if (count > 0) {
+        bytesReceived += count;
+        stateTime = cydWeeWXMillis();
+        consume(slice, count);
+      } else if (count == 0) {  // Connection closed by the server
+        if ((state == cydwwxfetchstate::READING_BODY) && (bodyMode == cydwwxbodymode::UNTIL_CLOSE)) {
+          dropConnection();
+          finish();
+        } else if (!retryOnNewConnection()) {
+          fail("connection closed");
+        }
+      } else if (count != CYD_WWX_TRANSPORT_WOULD_BLOCK) {
+        if (!retryOnNewConnection()) {
+          fail("read failed");
+        }
+      } else if (cydWeeWXMillis() - stateTime > CYD_WWX_HTTP_READ_TIMEOUT) {
+        fail("read timed out");
+      }
+    }
+
+    void consume(const uint8_t *data, size_t length) {
+      size_t i = 0;
+      while ((i < length) && isBusy()) {
+        if (state == cydwwxfetchstate::READING_HEADERS) {
+          if (readLine(data[i++])) {
+            handleHeaderLine();
+          }
+        } else if (bodyMode == cydwwxbodymode::CHUNKED) {
+          i += consumeChunked(data + i, length - i);
+        } else {
+          size_t count = length - i;
+          if ((bodyMode == cydwwxbodymode::LENGTH) && (count > (size_t)contentLength - encodedLength)) {
+            count = (size_t)contentLength - encodedLength;
+          }
+          appendBody(data + i, count);
+          i += count;
+          if ((bodyMode == cydwwxbodymode::LENGTH) && (encodedLength >= (size_t)contentLength) && isBusy()) {
+            finish();
+          }
+        }
+      }
+      if ((i < length) && (state == cydwwxfetchstate::DONE)) {
+        dropConnection();  // Unexpected bytes after the response, do not trust the connection
+      }
+    }
+
+    // Collect one line, returns true when a full line (without CR/LF) is in headerLine
+    bool readLine(uint8_t c) {
+      if (c == '\n') {
+        if ((headerLineLength > 0) && (headerLine[headerLineLength - 1] == '\r')) {
+          headerLineLength -= 1;
+        }
+        headerLine[headerLineLength] = '\0';
+        headerLineLength = 0;
+        return true;
+      }
+      if (headerLineLength < sizeof(headerLine) - 1) {
+        headerLine[headerLineLength++] = c;
+      }
+      return false;
+    }
+
+    void handleHeaderLine() {
+      if (!statusLineSeen) {
+        int minorVersion;
+        if (sscanf(headerLine, "HTTP/1.%d %d", &minorVersion, &statusCode) != 2) {
+          fail("bad status line");
+          return;
+        }
+        statusLineSeen = true;
+        serverKeepAlive = (minorVersion >= 1);
+        return;
+      }
+
+      if (headerLine[0] != '\0') {
+        const char *value = strchr(headerLine, ':');
+        if (value == nullptr) {
+          return;
+        }
+        value += 1;
+        while (*value == ' ') {
+          value += 1;
+        }
+        if (strncasecmp(headerLine, "Content-Length:", 15) == 0) {
+          contentLength = atol(value);
+        } else if (strncasecmp(headerLine, "Transfer-Encoding:", 18) == 0) {
+          if (strcasestr(value, "chunked") != nullptr) {
+            bodyMode = cydwwxbodymode::CHUNKED;
+          }
+        } else if (strncasecmp(headerLine, "Connection:", 11) == 0) {
+          if (strcasestr(value, "close") != nullptr) {
+            serverKeepAlive = false;
+          } else if (strcasestr(value, "keep-alive") != nullptr) {
+            serverKeepAlive = true;
+          }
+        } else if (strncasecmp(headerLine, "Content-Encoding:", 17) == 0) {
+          if ((inflater != nullptr) && (strcasestr(value, "gzip") != nullptr)) {
+            gzipped = true;
+          } else if (strcasecmp(value, "identity") != 0) {
+            fail("unsupported content encoding");
+          }
+        } else if (strncasecmp(headerLine, "ETag:", 5) == 0) {
+          copyValidator(eTag, value);
+        } else if (strncasecmp(headerLine, "Last-Modified:", 14) == 0) {
+          copyValidator(lastModified, value);
+        }
+        return;
+      }
+
+      // Empty line ends the headers
+      if (statusCode / 100 == 1) {  // Informational response, the real one follows
+        statusLineSeen = false;
+        return;
+      }
+      setState(cydwwxfetchstate::READING_BODY);
+      if ((statusCode == 204) || (statusCode == 304)) {
+        finish();
+      } else if (bodyMode == cydwwxbodymode::CHUNKED) {
+        chunkState = cydwwxchunkstate::SIZE;
+        chunkRemaining = 0;
+        chunkSizeDone = false;
+      } else if (contentLength >= 0) {
+        bodyMode = cydwwxbodymode::LENGTH;
+        if (contentLength == 0) {
+          finish();
+        }
+      } else {
+        serverKeepAlive = false;
+      }
+    }
+
+    // Keep a validator for the next conditional GET. One that does not fit is dropped rather than cut
+    // short, as a cut one would never match.
+    template <size_t N>
+    static void copyValidator(char (&validator)[N], const char *value) {
+      if (strlen(value) < N) {
+        strcpy(validator, value);
+      } else {
+        validator[0] = '\0';
+      }
+    }
+
+    // Remove the chunk framing, returns the number of bytes used
+    size_t consumeChunked(const uint8_t *data, size_t length) {
+      if (chunkState == cydwwxchunkstate::DATA) {
+        size_t count = (length < chunkRemaining) ? length : chunkRemaining;
+        appendBody(data, count);
+        chunkRemaining -= count;
+        if (chunkRemaining == 0) {
+          chunkState = cydwwxchunkstate::DATA_END;
+        }
+        return count;
+      }
+
+      uint8_t c = data[0];
+      switch (chunkState) {
+        case cydwwxchunkstate::SIZE:
+          if (c == '\n') {
+            chunkState = (chunkRemaining == 0) ? cydwwxchunkstate::TRAILER : cydwwxchunkstate::DATA;
+            chunkSizeDone = false;
+          } else if (!chunkSizeDone && isxdigit(c)) {
+            chunkRemaining = chunkRemaining * 16 + (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+          } else {
+            chunkSizeDone = true;  // Skip chunk extensions and the CR
+          }
+          break;
+        case cydwwxchunkstate::DATA_END:
+          if (c == '\n') {
+            chunkState = cydwwxchunkstate::SIZE;
+            chunkRemaining = 0;
+          }
+          break;
+        case cydwwxchunkstate::TRAILER:
+          if (readLine(c) && (headerLine[0] == '\0')) {
+            finish();
+          }
+          break;
+        default:
+          break;
+      }
+      return 1;
+    }
+
+    void appendBody(const uint8_t *data, size_t length) {
+      encodedLength += length;
+      if (gzipped) {
+        inflateBody(data, length);
+        return;
+      }
+      if (bodyLength + length > bodySize - 1) {
+        fail("response too large");
+        return;
+      }
+      memcpy(body + bodyLength, data, length);
+      bodyHash = fnv1aHash(bodyHash, data, length);
+      bodyLength += length;
+    }
+
+    // Inflate gzip encoded body bytes as they arrive. The response is parsed only once the fetch is
+    // done, so the whole inflated body is kept in the body buffer, which is also the inflate window.
+    // The compressed bytes are never buffered beyond the read slice, and each run of output is hashed
+    // as it is written. The only RAM gzip adds is the inflater, 10992 bytes for the ESP32 ROM tinfl.
+    // A body that inflates to more than the buffer fails as soon as the buffer is full.
+    void inflateBody(const uint8_t *data, size_t length) {
+      int64_t inflateStart = cydWeeWXMicros();
+      size_t i = 0;
+      while ((i < length) && isBusy()) {
+        if (gzipState == cydwwxgzipstate::DEFLATE) {
+          size_t inBytes = length - i;
+          size_t outBytes = bodySize - 1 - bodyLength;
+          tinfl_status status = tinfl_decompress(inflater, data + i, &inBytes, (mz_uint8 *)body, (mz_uint8 *)body + bodyLength, &outBytes,
+                                                 TINFL_FLAG_HAS_MORE_INPUT | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+          i += inBytes;
+          bodyHash = fnv1aHash(bodyHash, (const uint8_t *)body + bodyLength, outBytes);  // The inflated bytes, so both encodings hash the same
+          bodyLength += outBytes;
+          if (status == TINFL_STATUS_DONE) {
+            gzipState = cydwwxgzipstate::TRAILER;
+          } else if (status == TINFL_STATUS_HAS_MORE_OUTPUT) {
+            // The body buffer is the limit. Stop now rather than read the rest of a body that cannot be kept.
+            LOG_ERROR("cydWeeWXFetch", name << " gzip response inflates to more than " << (uint32_t)(bodySize - 1) << " bytes, stopped after "
+              << (uint32_t)encodedLength << " bytes received.");
+            fail("inflated response larger than the body buffer");
+          } else if (status < TINFL_STATUS_DONE) {
+            fail("inflate failed");
+          } else if (inBytes == 0) {
+            break;
+          }
+        } else if (gzipState == cydwwxgzipstate::TRAILER) {
+          i = length;
+        } else {
+          consumeGzipHeader(data[i++]);
+        }
+      }
+      inflateTime += (int32_t)(cydWeeWXMicros() - inflateStart);
+    }
+
+    // Skip over the gzip header one byte at a time
+    void consumeGzipHeader(uint8_t c) {
+      switch (gzipState) {
+        case cydwwxgzipstate::HEADER:
+          if (((gzipCount == 0) && (c != 0x1f)) || ((gzipCount == 1) && (c != 0x8b)) || ((gzipCount == 2) && (c != 8))) {
+            fail("bad gzip header");
+            return;
+          }
+          if (gzipCount == 3) {
+            gzipFlags = c;
+          }
+          gzipCount += 1;
+          if (gzipCount == 10) {
+            nextGzipField();
+          }
+          break;
+        case cydwwxgzipstate::EXTRA_LENGTH:
+          gzipRemaining |= (size_t)c << (8 * gzipCount);
+          gzipCount += 1;
+          if (gzipCount == 2) {
+            gzipState = cydwwxgzipstate::EXTRA;
+            if (gzipRemaining == 0) {
+              nextGzipField();
+            }
+          }
+          break;
+        case cydwwxgzipstate::EXTRA:
+          gzipRemaining -= 1;
+          if (gzipRemaining == 0) {
+            nextGzipField();
+          }
+          break;
+        case cydwwxgzipstate::NAME:
+        case cydwwxgzipstate::COMMENT:
+          if (c == 0) {
+            nextGzipField();
+          }
+          break;
+        case cydwwxgzipstate::HEADER_CRC:
+          gzipCount += 1;
+          if (gzipCount == 2) {
+            nextGzipField();
+          }
+          break;
+        default:
+          break;
+      }
+    }
+
+    // Move on to the next optional gzip header field that the flags say is present, or to the compressed data
+    void nextGzipField() {
+      gzipCount = 0;
+      gzipRemaining = 0;
+      if ((gzipState < cydwwxgzipstate::EXTRA_LENGTH) && (gzipFlags & 0x04)) {
+        gzipState = cydwwxgzipstate::EXTRA_LENGTH;
+      } else if ((gzipState < cydwwxgzipstate::NAME) && (gzipFlags & 0x08)) {
+        gzipState = cydwwxgzipstate::NAME;
+      } else if ((gzipState < cydwwxgzipstate::COMMENT) && (gzipFlags & 0x10)) {
+        gzipState = cydwwxgzipstate::COMMENT;
+      } else if ((gzipState < cydwwxgzipstate::HEADER_CRC) && (gzipFlags & 0x02)) {
+        gzipState = cydwwxgzipstate::HEADER_CRC;
+      } else {
+        tinfl_init(inflater);
+        gzipState = cydwwxgzipstate::DEFLATE;
+      }
+    }
+
+    void finish() {
+      if (gzipped && (encodedLength > 0) && (gzipState != cydwwxgzipstate::TRAILER)) {
+        fail("gzip data truncated");
+        return;
+      }
+      body[bodyLength] = '\0';
+      canReuse = serverKeepAlive && keepConnection;
+      if (!canReuse) {
+        dropConnection();
+      }
+      state = cydwwxfetchstate::DONE;
+    }
+};
+
+#endif  // CYD_WEEWX_FETCH
@@ -0,0 +1,100 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the WeeWX data file fields used by cydWeeWX
+// ** The full cyd_weewx.json file holds each field under a group name. The compact
+// ** feed (cyd_weewx_compact.json.tmpl) is an array in cydwwxfield order, so the
+// ** order must match the template.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_FIELDS
+#define CYD_WEEWX_FIELDS
+
+#include <ArduinoJson.h>
+
+// WeeWX data file fields used by cydWeeWX. The compact feed is an array in this order.
+enum class cydwwxfield {
+  TIME = 0,
+  LOCATION,
+  LATITUDE,
+  LONGITUDE,
+  SUNRISE,
+  SUNSET,
+  MOONRISE,
+  MOONSET,
+  IS_DAY,
+  MOON_FULLNESS,
+  MOON_WAXING,
+  TEMPERATURE,
+  TEMPERATURE_TREND,
+  HUMIDITY,
+  HUMIDITY_TREND,
+  INSIDE_TEMPERATURE,
+  INSIDE_HUMIDITY,
+  WIND,
+  WIND_TREND,
+  WIND_GUST,
+  WIND_GUST_TREND,
+  WIND_DIRECTION,
+  PRESSURE,
+  PRESSURE_TREND,
+  RAIN_RATE,
+  RAIN_RATE_TREND,
+  GENERATION_EPOCH,
+  MAX_FIELDS
+};
+
+// Where each field is found in the full WeeWX JSON file. Fields with units are {"value": x, "units": "u"}
+// objects in the full file and [x, "u"] arrays in the compact feed.
+struct weeWXFieldKey {
+  const char *group;
+  const char *name;
+  bool hasUnits;
+};
+
+const weeWXFieldKey weeWXFieldKeys[(unsigned int)cydwwxfield::MAX_FIELDS] = {
+  {.group="generation", .name="time", .hasUnits=false},                 // TIME
+  {.group="station", .name="location", .hasUnits=false},                // LOCATION
+  {.group="station", .name="latitude", .hasUnits=false},                // LATITUDE
+  {.group="station", .name="longitude", .hasUnits=false},               // LONGITUDE
+  {.group="almanac", .name="sunrise", .hasUnits=false},                 // SUNRISE
+  {.group="almanac", .name="sunset", .hasUnits=false},                  // SUNSET
+  {.group="almanac", .name="moonrise", .hasUnits=false},                // MOONRISE
+  {.group="almanac", .name="moonset", .hasUnits=false},                 // MOONSET
+  {.group="almanac", .name="is day", .hasUnits=false},                  // IS_DAY
+  {.group="almanac", .name="moon fullness", .hasUnits=false},           // MOON_FULLNESS
+  {.group="almanac", .name="moon waxing", .hasUnits=false},             // MOON_WAXING
+  {.group="current", .name="temperature", .hasUnits=true},              // TEMPERATURE
+  {.group="current", .name="temperature trend", .hasUnits=true},        // TEMPERATURE_TREND
+  {.group="current", .name="humidity", .hasUnits=true},                 // HUMIDITY
+  {.group="current", .name="humidity trend", .hasUnits=true},           // HUMIDITY_TREND
+  {.group="current", .name="inside temperature", .hasUnits=true},       // INSIDE_TEMPERATURE
+  {.group="current", .name="inside humidity", .hasUnits=true},          // INSIDE_HUMIDITY
+  {.group="current", .name="wind speed", .hasUnits=true},               // WIND
+  {.group="current", .name="wind speed trend", .hasUnits=true},         // WIND_TREND
+  {.group="current", .name="wind gust", .hasUnits=true},                // WIND_GUST
+  {.group="current", .name="wind gust trend", .hasUnits=true},          // WIND_GUST_TREND
+  {.group="current", .name="wind direction", .hasUnits=true},           // WIND_DIRECTION
+  {.group="current", .name="barometer", .hasUnits=true},                // PRESSURE
+  {.group="current", .name="barometer trend", .hasUnits=true},          // PRESSURE_TREND
+  {.group="current", .name="rain rate", .hasUnits=true},                // RAIN_RATE
+  {.group="current", .name="rain rate trend", .hasUnits=true},          // RAIN_RATE_TREND
+  {.group="generation", .name="epoch", .hasUnits=false}                 // GENERATION_EPOCH
+};
+
+// Build the WeeWX field projection filter for the full JSON file from the fields in weeWXFieldKeys
+inline void buildWeeWXFilter(JsonDocument &filter) {
+  filter.clear();
+  for (const weeWXFieldKey &key : weeWXFieldKeys) {
+    if (key.hasUnits) {
+      filter[key.group][key.name]["value"] = true;
+      filter[key.group][key.name]["units"] = true;
+    } else {
+      filter[key.group][key.name] = true;
+    }
+  }
+  filter.shrinkToFit();
+}
+
+#endif  // CYD_WEEWX_FIELDS
@@ -0,0 +1,90 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the number formatting for the readings
+// ** Writes a value with a fixed number of decimal places, giving the same text as
+// ** printf("%*.*f") without printf's float conversion or any heap use. The value is
+// ** rounded exactly, ties to even, as printf does. Only standard C++ is used so it
+// ** also builds on a desktop host.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_FORMAT
+#define CYD_WEEWX_FORMAT
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Write value like snprintf(buffer, size, "%*.*f", width, decimals, value). Up to 3 decimal places are
+// supported. Returns the length of the text, which is cut short if the buffer is too small.
+inline int formatFixed(char *buffer, size_t size, double value, int width, int decimals) {
+  static const uint64_t powersOfTen[] = {1, 10, 100, 1000};
+
+  // Very large numbers, infinity and NaN are rare enough to leave to printf
+  if ((decimals < 0) || (decimals > 3) || (width > 24) || !(fabs(value) < 1e15)) {
+    return snprintf(buffer, size, "%*.*f", width, decimals, value);
+  }
+
+  // value is mantissa * 2^exponent exactly, so value * 10^decimals can be rounded in integers
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bool negative = (bits >> 63) != 0;
+  int exponent = (int)((bits >> 52) & 0x7FF);
+  uint64_t mantissa = bits & 0xFFFFFFFFFFFFFULL;
+  if (exponent == 0) {
+    exponent = 1;  // Subnormal
+  } else {
+    mantissa |= 1ULL << 52;
+  }
+  exponent -= 1075;
+
+  uint64_t scaled = mantissa * powersOfTen[decimals];  // Below 2^63
+  uint64_t rounded;
+  if (exponent >= 0) {
+    rounded = scaled << exponent;  // Below 10^18 as the value is below 10^15
+  } else if (exponent > -64) {
+    int shift = -exponent;
+    rounded = scaled >> shift;
+    uint64_t remainder = scaled & ((1ULL << shift) - 1);
+    uint64_t half = 1ULL << (shift - 1);
+    if ((remainder > half) || ((remainder == half) && (rounded & 1))) {
+      rounded += 1;
+    }
+  } else {
+    rounded = 0;  // Less than half of the last place
+  }
+
+  // Digits are written from the end of the text
+  char text[32];
+  char *start = text + sizeof(text);
+  for (int place = 0; place < decimals; place++) {
+    *--start = (char)('0' + rounded % 10);
+    rounded /= 10;
+  }
+  if (decimals > 0) {
+    *--start = '.';
+  }
+  do {
+    *--start = (char)('0' + rounded % 10);
+    rounded /= 10;
+  } while (rounded != 0);
+  if (negative) {
+    *--start = '-';
+  }
+  while ((start > text) && (text + sizeof(text) - start < width)) {
+    *--start = ' ';
+  }
+
+  int length = (int)(text + sizeof(text) - start);
+  if (size > 0) {
+    size_t copied = ((size_t)length < size) ? (size_t)length : size - 1;
+    memcpy(buffer, start, copied);
+    buffer[copied] = '\0';
+  }
+  return length;
+}
+
+#endif  // CYD_WEEWX_FORMAT
@@ -0,0 +1,55 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the lock-free handoff between tasks
+// ** One task (the producer) fills a buffer and publishes it, the other task (the
+// ** consumer) picks up the most recently published buffer. Three buffers are used
+// ** so neither side ever waits for the other or sees a partly written value.
+// ** Only standard C++ is used so it also builds on a desktop host with std::thread.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_HANDOFF
+#define CYD_WEEWX_HANDOFF
+
+#include <atomic>
+#include <stdint.h>
+
+template <typename T>
+class cydWeeWXHandoff {
+  public:
+    // Producer only: the buffer to fill before calling publish()
+    T &writeBuffer() {
+      return buffers[writeIndex];
+    }
+
+    // Producer only: make the filled buffer the latest value and get a free buffer to write next
+    void publish() {
+      writeIndex = shared.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Consumer only: switch to the latest published value. Returns true if there was a new one.
+    bool update() {
+      if ((shared.load(std::memory_order_relaxed) & FRESH) == 0) {
+        return false;
+      }
+      readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+      return true;
+    }
+
+    // Consumer only: the value picked up by the last update(). Stays valid until the next update().
+    const T &read() const {
+      return buffers[readIndex];
+    }
+
+  private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t FRESH = 0x04;   // Set in shared when it holds a value the consumer has not seen
+
+    T buffers[3];
+    uint8_t writeIndex = 0;              // Owned by the producer
+    uint8_t readIndex = 1;               // Owned by the consumer
+    std::atomic<uint8_t> shared{2};      // Buffer passed between them
+};
+
+#endif  // CYD_WEEWX_HANDOFF
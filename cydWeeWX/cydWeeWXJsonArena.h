@@ -0,0 +1,198 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the ArduinoJson allocators for the query
+// ** JsonDocuments. With CYD_WWX_JSON_ARENA the documents come from a buffer reserved
+// ** at build time so parsing a query response does not fragment the heap. Without it
+// ** they come from the heap through cydWeeWXCountingAllocator, which is also what
+// ** test/measureJsonArena.cpp uses to measure the peak CYD_WWX_JSON_ARENA_SIZE is
+// ** sized from.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_JSON_ARENA
+#define CYD_WEEWX_JSON_ARENA
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#include "cydWeeWXLog.h"
+
+// Allocator that keeps track of the memory held by a JsonDocument so document sizes can be logged
+class cydWeeWXCountingAllocator : public ArduinoJson::Allocator {
+  public:
+    size_t currentSize = 0;
+    size_t peakSize = 0;
+
+    void* allocate(size_t size) override {
+      size_t* block = (size_t*)malloc(size + sizeof(size_t));
+      if (block == nullptr) {
+        return nullptr;
+      }
+      *block = size;
+      addSize(size);
+      return block + 1;
+    }
+
+    void deallocate(void* ptr) override {
+      if (ptr == nullptr) {
+        return;
+      }
+      size_t* block = (size_t*)ptr - 1;
+      currentSize -= *block;
+      free(block);
+    }
+
+    void* reallocate(void* ptr, size_t newSize) override {
+      if (ptr == nullptr) {
+        return allocate(newSize);
+      }
+      size_t* block = (size_t*)ptr - 1;
+      size_t oldSize = *block;
+      size_t* newBlock = (size_t*)realloc(block, newSize + sizeof(size_t));
+      if (newBlock == nullptr) {
+        return nullptr;
+      }
+      *newBlock = newSize;
+      currentSize -= oldSize;
+      addSize(newSize);
+      return newBlock + 1;
+    }
+
+  private:
+    void addSize(size_t size) {
+      currentSize += size;
+      if (currentSize > peakSize) {
+        peakSize = currentSize;
+      }
+    }
+};
+
+#ifdef CYD_WWX_JSON_ARENA
+// Allocator that hands out blocks from a buffer reserved at build time. Blocks are taken from the
+// top of the buffer. ArduinoJson grows and shrinks the block it allocated last, so that is done in
+// place. Space freed below the top is only given back when the buffer is empty again. A block that
+// does not fit comes from the heap and is counted as an overflow.
+class cydWeeWXArenaAllocator : public ArduinoJson::Allocator {
+  public:
+    size_t currentSize = 0;
+    size_t peakSize = 0;
+    uint32_t overflowCount = 0;   // Blocks taken from the heap because the arena was full
+
+    // Start over for the next query. Every document using the arena must have been destroyed. If a
+    // block was not given back it is logged and its space taken back anyway, so it cannot keep the
+    // arena full for every query after it.
+    void reset() {
+      if (blockCount != 0) {
+        LOG_ERROR("cydWeeWXArenaAllocator::reset", "JSON arena blocks still in use: " << (uint32_t)blockCount << ", "
+          << (uint32_t)top << " bytes taken back.");
+      }
+      top = 0;
+      blockCount = 0;
+      currentSize = 0;
+      peakSize = 0;
+    }
+
+    void* allocate(size_t size) override {
+      uint8_t* block;
+      if (blockSpace(size) <= sizeof(arena) - top) {
+        block = arena + top;
+        top += blockSpace(size);
+        blockCount += 1;
+      } else {
+        block = (uint8_t*)malloc(size + CYD_WWX_ARENA_HEADER);
+        if (block == nullptr) {
+          return nullptr;
+        }
+        overflowCount += 1;
+      }
+      *(size_t*)block = size;
+      addSize(size);
+      return block + CYD_WWX_ARENA_HEADER;
+    }
+
+    void deallocate(void* ptr) override {
+      if (ptr == nullptr) {
+        return;
+      }
+      uint8_t* block = (uint8_t*)ptr - CYD_WWX_ARENA_HEADER;
+      size_t size = *(size_t*)block;
+      currentSize -= size;
+      if (!inArena(block)) {
+        free(block);
+        return;
+      }
+      if (isTop(block, size)) {
+        top = block - arena;
+      }
+      blockCount -= 1;
+      if (blockCount == 0) {
+        top = 0;
+      }
+    }
+
+    void* reallocate(void* ptr, size_t newSize) override {
+      if (ptr == nullptr) {
+        return allocate(newSize);
+      }
+      uint8_t* block = (uint8_t*)ptr - CYD_WWX_ARENA_HEADER;
+      size_t oldSize = *(size_t*)block;
+      if (!inArena(block)) {
+        uint8_t* newBlock = (uint8_t*)realloc(block, newSize + CYD_WWX_ARENA_HEADER);
+        if (newBlock == nullptr) {
+          return nullptr;
+        }
+        *(size_t*)newBlock = newSize;
+        currentSize -= oldSize;
+        addSize(newSize);
+        return newBlock + CYD_WWX_ARENA_HEADER;
+      }
+      bool fitsInPlace = blockSpace(newSize) <= blockSpace(oldSize);
+      if (isTop(block, oldSize) && (blockSpace(newSize) <= sizeof(arena) - (block - arena))) {
+        top = (block - arena) + blockSpace(newSize);
+        fitsInPlace = true;
+      }
+      if (fitsInPlace) {
+        *(size_t*)block = newSize;
+        currentSize -= oldSize;
+        addSize(newSize);
+        return ptr;
+      }
+      void* newPtr = allocate(newSize);
+      if (newPtr == nullptr) {
+        return nullptr;
+      }
+      memcpy(newPtr, ptr, oldSize);
+      deallocate(ptr);
+      return newPtr;
+    }
+
+  private:
+    alignas(CYD_WWX_ARENA_HEADER) uint8_t arena[CYD_WWX_JSON_ARENA_SIZE];
+    size_t top = 0;               // Offset of the first free byte
+    size_t blockCount = 0;        // Blocks in use in the arena
+
+    // Blocks are kept aligned for any type ArduinoJson stores in them
+    static size_t blockSpace(size_t size) {
+      return CYD_WWX_ARENA_HEADER + ((size + CYD_WWX_ARENA_HEADER - 1) & ~(size_t)(CYD_WWX_ARENA_HEADER - 1));
+    }
+
+    bool inArena(const uint8_t* block) const {
+      return (block >= arena) && (block < arena + sizeof(arena));
+    }
+
+    bool isTop(const uint8_t* block, size_t size) const {
+      return block + blockSpace(size) == arena + top;
+    }
+
+    void addSize(size_t size) {
+      currentSize += size;
+      if (currentSize > peakSize) {
+        peakSize = currentSize;
+      }
+    }
+};
+#endif  // CYD_WWX_JSON_ARENA
+
+#endif  // CYD_WEEWX_JSON_ARENA
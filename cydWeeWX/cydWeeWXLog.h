@@ -0,0 +1,44 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the logging macros
+// ** The log stream and levels are chosen in cydWeeWXDefines.h, which includes this
+// ** file. Headers that log include it directly so they do not depend on the order of
+// ** the includes in the sketch.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_LOG
+#define CYD_WEEWX_LOG
+
+#include <Arduino.h>
+
+#ifndef CYD_WEEWX_LOG_OUTPUT
+#define CYD_WEEWX_LOG_OUTPUT Serial                 // Stream to send Logs to - Serial is default
+#endif  // CYD_WEEWX_LOG_OUTPUT
+
+#if defined CYD_WEEWX_ENABLE_DEBUG_LOG || defined CYD_WEEWX_ENABLE_INFO_LOG || defined CYD_WEEWX_ENABLE_ERROR_LOG
+template <class T>
+inline Print &operator<<(Print &obj, T arg)
+{
+    obj.print(arg);
+    return obj;
+}
+#endif  // CYD_WEEWX_ENABLE_DEBUG_LOG || CYD_WEEWX_ENABLE_INFO_LOG || CYD_WEEWX_ENABLE_ERROR_LOG
+#ifdef CYD_WEEWX_ENABLE_DEBUG_LOG
+#define LOG_DEBUG(svc, content) CYD_WEEWX_LOG_OUTPUT << "DEBUG: <" << svc << "> " << content << "\r\n"
+#else
+#define LOG_DEBUG(svc, content)
+#endif  // CYD_WEEWX_ENABLE_DEBUG_LOG
+#ifdef CYD_WEEWX_ENABLE_INFO_LOG
+#define LOG_INFO(svc, content) CYD_WEEWX_LOG_OUTPUT << "INFO: <" << svc << "> " << content << "\r\n"
+#else
+#define LOG_INFO(svc, content)
+#endif  // CYD_WEEWX_ENABLE_INFO_LOG
+#ifdef CYD_WEEWX_ENABLE_ERROR_LOG
+#define LOG_ERROR(svc, content) CYD_WEEWX_LOG_OUTPUT << "ERROR: <" << svc << "> " << content << "\r\n"
+#else
+#define LOG_ERROR(svc, content)
+#endif  // CYD_WEEWX_ENABLE_ERROR_LOG
+
+#endif  // CYD_WEEWX_LOG
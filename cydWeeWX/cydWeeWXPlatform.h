@@ -0,0 +1,56 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the few ESP32 services the network code uses
+// ** cydWeeWXFetch and the transports only need a clock, the free heap and the ROM
+// ** inflater. On the ESP32 they come from ESP-IDF. On a desktop host they come from
+// ** the C++ library and the miniz library, so the fetch and transport code also
+// ** builds for the tests in test/.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_PLATFORM
+#define CYD_WEEWX_PLATFORM
+
+#include <stdint.h>
+#ifdef ESP_PLATFORM
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <rom/miniz.h>
+#else
+#include <chrono>
+#include <miniz.h>
+
+// Added to the host clock so tests can reach timeouts without waiting for them (usec)
+inline int64_t cydWeeWXHostClockOffset = 0;
+#endif  // ESP_PLATFORM
+
+// Time since boot in usec
+inline int64_t cydWeeWXMicros() {
+#ifdef ESP_PLATFORM
+  return esp_timer_get_time();
+#else
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+    + cydWeeWXHostClockOffset;
+#endif  // ESP_PLATFORM
+}
+
+// Time since boot in msec. Wraps around like millis().
+inline uint32_t cydWeeWXMillis() {
+#ifdef ESP_PLATFORM
+  return millis();
+#else
+  return (uint32_t)(cydWeeWXMicros() / 1000);
+#endif  // ESP_PLATFORM
+}
+
+// Free heap in bytes, 0 where it is not known
+inline uint32_t cydWeeWXFreeHeap() {
+#ifdef ESP_PLATFORM
+  return ESP.getFreeHeap();
+#else
+  return 0;
+#endif  // ESP_PLATFORM
+}
+
+#endif  // CYD_WEEWX_PLATFORM
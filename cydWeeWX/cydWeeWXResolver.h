@@ -0,0 +1,107 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the host name cache
+// ** Looking up a host name, and mDNS .local names in particular, can take hundreds of
+// ** msec and fails now and then. Addresses are kept for a while so most connections
+// ** need no lookup, failed lookups are not retried straight away, and when a lookup
+// ** fails the last address that was found is used instead.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_RESOLVER
+#define CYD_WEEWX_RESOLVER
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "cydWeeWXLog.h"
+#include "cydWeeWXPlatform.h"
+
+struct cydWeeWXResolverEntry {
+  char host[CYD_WWX_FETCH_HOST_LENGTH] = "";
+  IPAddress address;
+  bool known = false;                   // address has been found at least once
+  uint32_t expires = 0;                 // cydWeeWXMillis() time address must be looked up again
+  uint32_t retryTime = 0;               // cydWeeWXMillis() time a failed lookup may be tried again
+  bool lookupFailed = false;            // The last lookup failed
+  uint32_t lastUsed = 0;
+};
+
+class cydWeeWXResolver {
+  public:
+    uint32_t lookups = 0;               // Lookups made
+    uint32_t cacheHits = 0;             // Addresses used from the cache without a lookup
+    uint32_t fallbacks = 0;             // Last known addresses used because the lookup failed or was not retried yet
+    uint32_t failures = 0;              // Lookups that failed
+
+    // Get the address of host. A fresh cached address is used without a lookup. If the lookup fails
+    // the last address that was found is used. Returns false if no address for host is known.
+    bool resolve(const char *host, IPAddress &address) {
+      if (address.fromString(host)) {   // Already an address
+        return true;
+      }
+      cydWeeWXResolverEntry &entry = findEntry(host);
+      uint32_t now = cydWeeWXMillis();
+      entry.lastUsed = now;
+      if (entry.known && ((int32_t)(entry.expires - now) > 0)) {
+        cacheHits += 1;
+        address = entry.address;
+        return true;
+      }
+
+      if (!entry.lookupFailed || ((int32_t)(now - entry.retryTime) >= 0)) {
+        IPAddress found;
+        lookups += 1;
+        if ((WiFi.hostByName(host, found) == 1) && (found != IPAddress())) {
+          entry.address = found;
+          entry.known = true;
+          entry.lookupFailed = false;
+          entry.expires = cydWeeWXMillis() + CYD_WWX_RESOLVER_TTL;
+          address = found;
+          return true;
+        }
+        failures += 1;
+        entry.lookupFailed = true;
+        entry.retryTime = cydWeeWXMillis() + CYD_WWX_RESOLVER_NEGATIVE_TTL;
+        LOG_ERROR("cydWeeWXResolver", "Lookup of " << host << " failed" << (entry.known ? ", using the last known address." : "."));
+      }
+
+      if (!entry.known) {
+        return false;
+      }
+      fallbacks += 1;
+      address = entry.address;
+      return true;
+    }
+
+    // The address of host did not work, so look it up again next time. It is still kept in case that lookup fails.
+    void expire(const char *host) {
+      for (cydWeeWXResolverEntry &entry : entries) {
+        if (strcmp(entry.host, host) == 0) {
+          entry.expires = cydWeeWXMillis();
+          entry.lookupFailed = false;
+        }
+      }
+    }
+
+  private:
+    cydWeeWXResolverEntry entries[CYD_WWX_RESOLVER_CACHE_SIZE];
+
+    // Entry for host, replacing the least recently used one if host is not cached
+    cydWeeWXResolverEntry &findEntry(const char *host) {
+      cydWeeWXResolverEntry *oldest = &entries[0];
+      for (cydWeeWXResolverEntry &entry : entries) {
+        if (strcmp(entry.host, host) == 0) {
+          return entry;
+        }
+        if ((int32_t)(entry.lastUsed - oldest->lastUsed) < 0) {
+          oldest = &entry;
+        }
+      }
+      *oldest = cydWeeWXResolverEntry();
+      strlcpy(oldest->host, host, sizeof(oldest->host));
+      return *oldest;
+    }
+};
+
+#endif  // CYD_WEEWX_RESOLVER
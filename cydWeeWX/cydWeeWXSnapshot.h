@@ -0,0 +1,110 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the weather snapshot shown on the main display
+// ** The network task builds a snapshot from the WeeWX and Open-Meteo queries and hands
+// ** complete copies to the display through a cydWeeWXHandoff. All text is held in
+// ** fixed size arrays, so updating and copying a snapshot never uses the heap and a
+// ** device running for months does not fragment it. Text that does not fit is cut
+// ** short.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_SNAPSHOT
+#define CYD_WEEWX_SNAPSHOT
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+enum class cydwwxsensor {
+    TEMPERATURE = 0,
+    HUMIDITY,
+    WIND,
+    WIND_GUST,
+    PRESSURE,
+    RAIN_RATE,
+    MAX_SENSORS
+};
+
+// Text shown for one of the main readings
+struct cydWeeWXReadingText {
+  char value[CYD_WWX_READING_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char trend[CYD_WWX_ICON_TEXT_LENGTH] = "";          // Trend arrow icon
+  char units[CYD_WWX_UNITS_TEXT_LENGTH] = "";
+};
+
+// Everything shown on the main display that comes from the WeeWX and Open-Meteo queries
+struct cydWeeWXSnapshot {
+  char location[CYD_WWX_LOCATION_TEXT_LENGTH] = "";
+  char latitude[CYD_WWX_COORDINATE_TEXT_LENGTH] = "";
+  char longitude[CYD_WWX_COORDINATE_TEXT_LENGTH] = "";
+  char screenHeader[CYD_WWX_HEADER_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_HEADER;
+
+  char sunrise[CYD_WWX_TIME_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char sunset[CYD_WWX_TIME_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char moonrise[CYD_WWX_TIME_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char moonset[CYD_WWX_TIME_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char moonPhase[CYD_WWX_MOON_PHASE_TEXT_LENGTH] = "";
+  char iconMoonPhase[CYD_WWX_ICON_TEXT_LENGTH] = "";
+
+  cydWeeWXReadingText readings[(unsigned int)cydwwxsensor::MAX_SENSORS];  // Indexed by cydwwxsensor
+  char insideTemperature[CYD_WWX_READING_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char insideHumidity[CYD_WWX_READING_TEXT_LENGTH] = CYD_WWX_PLACEHOLDER_READING;
+  char windDirection[CYD_WWX_ICON_TEXT_LENGTH] = "";  // There is no separate gust direction so it is shown for both
+
+  // Weather WMO Icon related values
+  bool isDay = true;
+  int weatherCode = CYD_WWX_LOADING_STATE_CODE;
+
+  // Station time, sunrise and sunset used by the backlight dimmer
+  int currentTimeInMinutes = 0;
+  int sunriseTimeInMinutes = 0;
+  int sunsetTimeInMinutes = 0;
+
+  // Query error state and Label text
+  int errorState = CYD_WWX_NO_ERROR;
+  char errorHeaderMessage[CYD_WWX_ERROR_TEXT_LENGTH] = "";
+
+  uint32_t generation = 0;            // Network configuration generation the snapshot was built for
+  bool initialQueriesDone = false;    // First WeeWX and Open-Meteo queries of the generation are finished
+#ifdef CYD_WWX_MQTT
+  int64_t updateReceivedTime = 0;     // When the oldest MQTT update in the snapshot arrived (usec), 0 if none
+#endif  // CYD_WWX_MQTT
+
+  // WeeWX query recovery progress
+  uint32_t recoveryFailures = 0;      // WeeWX queries failed in a row
+  uint32_t recoveryRetryTime = 0;     // millis() time of the next retry, or of the reboot while WiFi is down
+  bool recoveryRebootNext = false;    // The device reboots if the next retry fails too
+  bool wifiDown = false;              // Queries are paused until WiFi reconnects
+
+  cydWeeWXReadingText &reading(cydwwxsensor sensor) {
+    return readings[(unsigned int)sensor];
+  }
+
+  const cydWeeWXReadingText &reading(cydwwxsensor sensor) const {
+    return readings[(unsigned int)sensor];
+  }
+};
+
+// Handing a snapshot to the display is a plain copy
+static_assert(std::is_trivially_copyable<cydWeeWXSnapshot>::value, "cydWeeWXSnapshot must not hold heap allocated members");
+
+// Copy text into a snapshot field, cut short if it does not fit. nullptr clears the field.
+// Returns true if the field changed.
+template <size_t N>
+bool setSnapshotText(char (&field)[N], const char *text) {
+  if (text == nullptr) {
+    text = "";
+  }
+  size_t length = strnlen(text, N - 1);
+  if ((strlen(field) == length) && (memcmp(field, text, length) == 0)) {
+    return false;
+  }
+  memcpy(field, text, length);
+  field[length] = '\0';
+  return true;
+}
+
+#endif  // CYD_WEEWX_SNAPSHOT
@@ -0,0 +1,210 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the parsing of the WeeWX time stamps
+// ** The report time is turned into epoch seconds and the station's UTC offset in one
+// ** pass over the text, and the almanac times into seconds since midnight. Everything
+// ** else works from those numbers. Nothing is allocated and only standard C++ is used
+// ** so it also builds on a desktop host.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_TIME
+#define CYD_WEEWX_TIME
+
+#include <stdint.h>
+#include <string.h>
+
+#define CYD_WWX_SECONDS_PER_DAY 86400
+
+// Report time from the WeeWX generation.time field
+struct cydWeeWXTimestamp {
+  int64_t epoch = 0;          // Seconds since 1970-01-01 UTC
+  int32_t utcOffset = 0;      // Station local time minus UTC (seconds)
+  bool hasOffset = false;     // False for the "human" format, which names the time zone instead
+
+  // Station local time as seconds since 1970-01-01
+  int64_t localTime() const {
+    return epoch + utcOffset;
+  }
+};
+
+// Station local date and time of day
+struct cydWeeWXLocalTime {
+  int year;
+  int month;                  // 1 to 12
+  int day;                    // 1 to 31
+  int secondOfDay;            // 0 to 86399
+};
+
+// Days from 1970-01-01 to a date in the proleptic Gregorian calendar (Howard Hinnant's days_from_civil)
+inline int64_t daysFromCivil(int year, int month, int day) {
+  year -= (month <= 2);
+  int64_t era = ((year >= 0) ? year : year - 399) / 400;
+  int64_t yearOfEra = year - era * 400;                                                  // 0 to 399
+  int64_t dayOfYear = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;        // 0 to 365
+  int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;      // 0 to 146096
+  return era * 146097 + dayOfEra - 719468;
+}
+
+// Date and time of day of a local time in seconds since 1970-01-01 (Howard Hinnant's civil_from_days)
+inline cydWeeWXLocalTime getLocalTime(int64_t localTime) {
+  int64_t days = localTime / CYD_WWX_SECONDS_PER_DAY;
+  int64_t second = localTime % CYD_WWX_SECONDS_PER_DAY;
+  if (second < 0) {
+    days -= 1;
+    second += CYD_WWX_SECONDS_PER_DAY;
+  }
+  days += 719468;
+  int64_t era = ((days >= 0) ? days : days - 146096) / 146097;
+  int64_t dayOfEra = days - era * 146097;
+  int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+  cydWeeWXLocalTime local;
+  local.day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+  local.month = (int)(monthIndex + ((monthIndex < 10) ? 3 : -9));
+  local.year = (int)(yearOfEra + era * 400 + (local.month <= 2));
+  local.secondOfDay = (int)second;
+  return local;
+}
+
+// Read exactly count digits. Returns -1 if they are not all digits.
+inline int parseDigits(const char *&text, int count) {
+  int value = 0;
+  for (int digit = 0; digit < count; digit++) {
+    if ((*text < '0') || (*text > '9')) {
+      return -1;
+    }
+    value = value * 10 + (*text++ - '0');
+  }
+  return value;
+}
+
+// Read HH:MM:SS or HH:MM into seconds since midnight. Returns -1 if it is not a time of day.
+inline int parseClockTime(const char *&text) {
+  int hour = parseDigits(text, 2);
+  if ((hour < 0) || (hour > 23) || (*text++ != ':')) {
+    return -1;
+  }
+  int minute = parseDigits(text, 2);
+  if ((minute < 0) || (minute > 59)) {
+    return -1;
+  }
+  int second = 0;
+  if (*text == ':') {
+    text++;
+    second = parseDigits(text, 2);
+    if ((second < 0) || (second > 60)) {  // 60 for a leap second
+      return -1;
+    }
+  }
+  return hour * 3600 + minute * 60 + second;
+}
+
+// Almanac time (HH:MM:SS) in seconds since midnight, -1 if there is none (N/A in the polar summer or winter)
+inline int parseAlmanacTime(const char *text) {
+  if (text == nullptr) {
+    return -1;
+  }
+  return parseClockTime(text);
+}
+
+// Parse a WeeWX report time. Two formats are sent, chosen by timestamp_fmt in skin.conf:
+//   iso:   2024-11-26T12:40:00-0500 (%Y-%m-%dT%H:%M:%S%z)
+//   human: Tue, 26 Nov 2024 12:40:00 EST (%a, %d %b %Y %H:%M:%S %Z)
+// The human format has no UTC offset, so the epoch is only right once the offset is known, see
+// setUtcOffsetFromEpoch(). Returns false if the text is neither.
+inline bool parseWeeWXTimestamp(const char *text, cydWeeWXTimestamp &time) {
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  if (text == nullptr) {
+    return false;
+  }
+
+  int year;
+  int month = 0;
+  int day;
+  bool iso = (*text >= '0') && (*text <= '9');
+  if (iso) {
+    year = parseDigits(text, 4);
+    if ((year < 0) || (*text++ != '-')) {
+      return false;
+    }
+    month = parseDigits(text, 2);
+    if ((month < 0) || (*text++ != '-')) {
+      return false;
+    }
+    day = parseDigits(text, 2);
+    if ((day < 0) || ((*text++ | 0x20) != 't')) {
+      return false;
+    }
+  } else {
+    text = strchr(text, ' ');  // Skip the day name
+    if (text == nullptr) {
+      return false;
+    }
+    text++;
+    day = parseDigits(text, 2);
+    if ((day < 0) || (*text++ != ' ')) {
+      return false;
+    }
+    for (int index = 0; index < 12; index++) {
+      if (strncmp(text, months + index * 3, 3) == 0) {
+        month = index + 1;
+        break;
+      }
+    }
+    if (month == 0) {
+      return false;
+    }
+    text += 3;
+    if (*text++ != ' ') {
+      return false;
+    }
+    year = parseDigits(text, 4);
+    if ((year < 0) || (*text++ != ' ')) {
+      return false;
+    }
+  }
+  if ((month < 1) || (month > 12) || (day < 1) || (day > 31)) {
+    return false;
+  }
+  int secondOfDay = parseClockTime(text);
+  if (secondOfDay < 0) {
+    return false;
+  }
+  int64_t localTime = daysFromCivil(year, month, day) * CYD_WWX_SECONDS_PER_DAY + secondOfDay;
+
+  // ISO UTC offset: Z, +hhmm or +hh:mm
+  time.utcOffset = 0;
+  time.hasOffset = false;
+  if (iso && ((*text == 'Z') || (*text == 'z'))) {
+    time.hasOffset = true;
+  } else if (iso && ((*text == '+') || (*text == '-'))) {
+    int sign = (*text++ == '-') ? -1 : 1;
+    int hours = parseDigits(text, 2);
+    if (*text == ':') {
+      text++;
+    }
+    int minutes = parseDigits(text, 2);
+    if ((hours < 0) || (minutes < 0)) {
+      return false;
+    }
+    time.utcOffset = sign * (hours * 3600 + minutes * 60);
+    time.hasOffset = true;
+  }
+  time.epoch = localTime - time.utcOffset;
+  return true;
+}
+
+// Work out the UTC offset of a report time without one from the epoch of the same report
+inline void setUtcOffsetFromEpoch(cydWeeWXTimestamp &time, int64_t epoch) {
+  if (time.hasOffset || (epoch <= 0)) {
+    return;
+  }
+  time.utcOffset = (int32_t)(time.epoch - epoch);
+  time.epoch = epoch;
+  time.hasOffset = true;
+}
+
+#endif  // CYD_WEEWX_TIME
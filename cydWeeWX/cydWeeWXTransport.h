@@ -0,0 +1,347 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the connections used by cydWeeWXFetch
+// ** cydWeeWXFetch sends its request and reads the response through a transport, so
+// ** the same request, header, body and parse code can be run against:
+// **   - cydWeeWXTlsTransport:     a real server, plain TCP or TLS, using esp_tls
+// **   - cydWeeWXFixtureTransport: a response recorded in memory
+// **   - cydWeeWXFaultTransport:   another transport with latency, truncation and
+// **                               errors added to it
+// ** Only the esp_tls transport needs the ESP32. The others only need the clock from
+// ** cydWeeWXPlatform.h, so they also build on a desktop host.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_TRANSPORT
+#define CYD_WEEWX_TRANSPORT
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include "cydWeeWXPlatform.h"
+#ifdef ESP_PLATFORM
+#include <errno.h>
+#include <esp_tls.h>
+#include <lwip/sockets.h>
+
+// The Arduino NetworkClientSecure library has its own esp_crt_bundle.h that hides the ESP-IDF one
+extern "C" esp_err_t esp_crt_bundle_attach(void *conf);
+#endif  // ESP_PLATFORM
+
+// read() and write() results other than a byte count
+#define CYD_WWX_TRANSPORT_ERROR -1              // The connection failed
+#define CYD_WWX_TRANSPORT_WOULD_BLOCK -2        // Nothing can be done without waiting, try again in the next step
+
+// Results of connect()
+#define CYD_WWX_TRANSPORT_CONNECTED 1
+#define CYD_WWX_TRANSPORT_CONNECTING 0
+#define CYD_WWX_TRANSPORT_CONNECT_FAILED -1
+
+class cydWeeWXTransport {
+  public:
+    bool sessionOffered = false;        // A saved TLS session was offered to the server by the last open()
+
+    virtual ~cydWeeWXTransport() {}
+
+    // Start a connection to host, which may be an address. Returns false if it cannot be started.
+    virtual bool open(const char *host, uint16_t port, bool secure) = 0;
+    // Advance the connection started by open() without blocking
+    virtual int connect() = 0;
+    // Send or receive up to length bytes. read() returns 0 once the server closed the connection.
+    virtual ssize_t write(const char *data, size_t length) = 0;
+    virtual ssize_t read(uint8_t *data, size_t length) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() = 0;
+    // False if the host name is not used, so there is no point looking it up first
+    virtual bool needsAddress() {
+      return true;
+    }
+};
+
+#ifdef ESP_PLATFORM
+// Connection to a real server. esp_tls is used for plain TCP as well, so both are non-blocking the same way.
+class cydWeeWXTlsTransport : public cydWeeWXTransport {
+  public:
+    // Settings for https connections. caPem pins the server CA instead of using the certificate bundle,
+    // cipherSuites is a 0 terminated list of mbedTLS cipher suite ids to offer, and resumeSessions keeps
+    // the TLS session so the next connection can skip the full handshake. nullptr leaves the default.
+    void setTlsProfile(const char *caPem, const int *cipherSuites, bool resumeSessions) {
+      tlsCaPem = caPem;
+      tlsCipherSuites = cipherSuites;
+      tlsResumeSessions = resumeSessions;
+    }
+
+    bool open(const char *host, uint16_t port, bool secure) override {
+      close();
+      tls = esp_tls_init();
+      if (tls == nullptr) {
+        return false;
+      }
+      strlcpy(this->host, host, sizeof(this->host));
+      this->port = port;
+      this->secure = secure;
+      sessionOffered = false;
+      tlsConfig = {};
+      tlsConfig.non_block = true;
+      tlsConfig.timeout_ms = CYD_WWX_FETCH_SELECT_TIMEOUT;  // Longest wait for the socket in one step
+      tlsConfig.is_plain_tcp = !secure;
+      if (secure) {
+        if (tlsCaPem != nullptr) {
+          tlsConfig.cacert_buf = (const unsigned char *)tlsCaPem;
+          tlsConfig.cacert_bytes = strlen(tlsCaPem) + 1;
+        } else {
+          tlsConfig.crt_bundle_attach = esp_crt_bundle_attach;
+        }
+        tlsConfig.ciphersuites_list = tlsCipherSuites;
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        if (tlsResumeSessions && (tlsSession != nullptr)) {
+          tlsConfig.client_session = tlsSession;
+          sessionOffered = true;
+        }
+#endif  // CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+      }
+      return true;
+    }
+
+    int connect() override {
+      int result = esp_tls_conn_new_async(host, strlen(host), port, &tlsConfig, tls);
+      if (result == 1) {
+        int sockfd;
+        if (esp_tls_get_conn_sockfd(tls, &sockfd) == ESP_OK) {
+          fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK);
+        }
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        tlsConfig.client_session = nullptr;
+        if (secure && tlsResumeSessions) {
+          // Keep the new session for the next connection
+          esp_tls_client_session_t *session = esp_tls_get_client_session(tls);
+          if (session != nullptr) {
+            forgetSession();
+            tlsSession = session;
+          }
+        }
+#endif  // CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        return CYD_WWX_TRANSPORT_CONNECTED;
+      }
+      if (result < 0) {
+        forgetSession();  // The server may have refused the saved session
+        return CYD_WWX_TRANSPORT_CONNECT_FAILED;
+      }
+      return CYD_WWX_TRANSPORT_CONNECTING;
+    }
+
+    ssize_t write(const char *data, size_t length) override {
+      errno = 0;
+      return result(esp_tls_conn_write(tls, data, length));
+    }
+
+    ssize_t read(uint8_t *data, size_t length) override {
+      errno = 0;
+      return result(esp_tls_conn_read(tls, data, length));
+    }
+
+    void close() override {
+      if (tls != nullptr) {
+        esp_tls_conn_destroy(tls);
+        tls = nullptr;
+      }
+    }
+
+    bool isOpen() override {
+      return tls != nullptr;
+    }
+
+  private:
+    esp_tls_t *tls = nullptr;
+    esp_tls_cfg_t tlsConfig = {};
+    const char *tlsCaPem = nullptr;
+    const int *tlsCipherSuites = nullptr;
+    bool tlsResumeSessions = false;
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    esp_tls_client_session_t *tlsSession = nullptr;  // Session of the last TLS connection, for resumption
+#endif  // CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    char host[128] = {};
+    uint16_t port = 80;
+    bool secure = false;
+
+    void forgetSession() {
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+      if (tlsSession != nullptr) {
+        esp_tls_free_client_session(tlsSession);
+        tlsSession = nullptr;
+      }
+#endif  // CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    }
+
+    ssize_t result(ssize_t count) {
+      if (count >= 0) {
+        return count;
+      }
+      if ((count == ESP_TLS_ERR_SSL_WANT_READ) || (count == ESP_TLS_ERR_SSL_WANT_WRITE) || (errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+        return CYD_WWX_TRANSPORT_WOULD_BLOCK;
+      }
+      return CYD_WWX_TRANSPORT_ERROR;
+    }
+};
+#endif  // ESP_PLATFORM
+
+// Replays a recorded response. head is the status line and headers, up to and including the blank
+// line, and body follows it. A whole recorded response may be given as head with a nullptr body.
+// The request is accepted and ignored, and the connection is closed after the response.
+class cydWeeWXFixtureTransport : public cydWeeWXTransport {
+  public:
+    cydWeeWXFixtureTransport(const char *head, const char *body) : head(head), body(body) {}
+
+    bool open(const char *host, uint16_t port, bool secure) override {
+      opened = true;
+      position = 0;
+      return true;
+    }
+
+    int connect() override {
+      return CYD_WWX_TRANSPORT_CONNECTED;
+    }
+
+    ssize_t write(const char *data, size_t length) override {
+      return length;
+    }
+
+    ssize_t read(uint8_t *data, size_t length) override {
+      size_t headLength = strlen(head);
+      size_t bodyLength = (body != nullptr) ? strlen(body) : 0;
+      size_t count = 0;
+      while ((count < length) && (position < headLength + bodyLength)) {
+        data[count++] = (position < headLength) ? head[position] : body[position - headLength];
+        position += 1;
+      }
+      return count;
+    }
+
+    void close() override {
+      opened = false;
+    }
+
+    bool isOpen() override {
+      return opened;
+    }
+
+    bool needsAddress() override {
+      return false;
+    }
+
+  private:
+    const char *head;
+    const char *body;
+    size_t position = 0;
+    bool opened = false;
+};
+
+// Passes another transport through with faults added, to see how the fetch and the code using it cope.
+// Set the public fields before a fetch. Zero (SIZE_MAX for the byte counts) leaves that fault out.
+class cydWeeWXFaultTransport : public cydWeeWXTransport {
+  public:
+    uint32_t latency = 0;               // Extra time to connect and to the first response byte (msec)
+    size_t readLimit = 0;               // Most bytes returned by one read, to trickle the response in
+    size_t truncateAfter = SIZE_MAX;    // Response bytes passed on before the server seems to close the connection
+    size_t errorAfter = SIZE_MAX;       // Response bytes passed on before the connection fails
+    bool refuseConnect = false;         // Every connection fails
+    int statusCode = 0;                 // Reply with this HTTP status and an empty body instead of the real response
+
+    cydWeeWXFaultTransport(cydWeeWXTransport *inner) : inner(inner) {}
+
+    bool open(const char *host, uint16_t port, bool secure) override {
+      opened = true;
+      openTime = cydWeeWXMillis();
+      received = 0;
+      injected = 0;
+      sessionOffered = false;
+      if ((statusCode != 0) || refuseConnect) {
+        snprintf(injectedResponse, sizeof(injectedResponse), "HTTP/1.1 %d Injected Fault\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", statusCode);
+        return true;  // The server is not contacted
+      }
+      bool result = inner->open(host, port, secure);
+      sessionOffered = inner->sessionOffered;
+      return result;
+    }
+
+    int connect() override {
+      if (cydWeeWXMillis() - openTime < latency) {
+        return CYD_WWX_TRANSPORT_CONNECTING;
+      }
+      if (refuseConnect) {
+        return CYD_WWX_TRANSPORT_CONNECT_FAILED;
+      }
+      int result = (statusCode != 0) ? CYD_WWX_TRANSPORT_CONNECTED : inner->connect();
+      if (result == CYD_WWX_TRANSPORT_CONNECTED) {
+        connectedTime = cydWeeWXMillis();
+      }
+      return result;
+    }
+
+    ssize_t write(const char *data, size_t length) override {
+      return (statusCode != 0) ? (ssize_t)length : inner->write(data, length);
+    }
+
+    ssize_t read(uint8_t *data, size_t length) override {
+      if (cydWeeWXMillis() - connectedTime < latency) {
+        return CYD_WWX_TRANSPORT_WOULD_BLOCK;
+      }
+      if (received >= errorAfter) {
+        return CYD_WWX_TRANSPORT_ERROR;
+      }
+      if (received >= truncateAfter) {
+        return 0;
+      }
+      size_t limit = length;
+      if ((readLimit > 0) && (readLimit < limit)) {
+        limit = readLimit;
+      }
+      limit = min3(limit, truncateAfter - received, errorAfter - received);
+
+      ssize_t count;
+      if (statusCode != 0) {
+        size_t left = strlen(injectedResponse) - injected;
+        count = (limit < left) ? limit : left;
+        memcpy(data, injectedResponse + injected, count);
+        injected += count;
+      } else {
+        count = inner->read(data, limit);
+      }
+      if (count > 0) {
+        received += count;
+      }
+      return count;
+    }
+
+    void close() override {
+      opened = false;
+      inner->close();
+    }
+
+    bool isOpen() override {
+      return opened;
+    }
+
+    bool needsAddress() override {
+      return (statusCode == 0) && !refuseConnect && inner->needsAddress();
+    }
+
+  private:
+    cydWeeWXTransport *inner;
+    bool opened = false;
+    uint32_t openTime = 0;
+    uint32_t connectedTime = 0;
+    size_t received = 0;                // Response bytes passed on
+    size_t injected = 0;                // Bytes of injectedResponse passed on
+    char injectedResponse[96] = {};
+
+    static size_t min3(size_t a, size_t b, size_t c) {
+      size_t m = (a < b) ? a : b;
+      return (m < c) ? m : c;
+    }
+};
+
+#endif  // CYD_WEEWX_TRANSPORT
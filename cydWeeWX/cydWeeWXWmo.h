@@ -0,0 +1,82 @@
+// **********************************************************************************
+// ** Include for cydWeeWX project with the WMO weather code inferred from the station
+// ** readings. Used instead of Open-Meteo, or when Open-Meteo cannot be reached.
+// ** It is a rule of thumb from what a home weather station measures: rain and its
+// ** rate, temperature, humidity and the barometer trend. Cloud cover cannot be
+// ** measured so it is estimated from the humidity and a falling barometer.
+// ** Only standard C++ is used so it also builds on a desktop host.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_WMO
+#define CYD_WEEWX_WMO
+
+#include <math.h>
+
+// Station readings in metric units. NAN for readings the station does not have.
+struct cydWeeWXStationReadings {
+  float temperature = NAN;          // Outside temperature (°C)
+  float humidity = NAN;             // Outside relative humidity (%)
+  float rainRate = NAN;             // Rain rate (mm/h)
+  float pressureTrend = NAN;        // Barometer change over the last hour (hPa)
+  bool isDay = true;
+};
+
+// Dewpoint (°C) from the temperature (°C) and relative humidity (%), Magnus formula
+inline float cydWeeWXDewpoint(float temperature, float humidity) {
+  const float b = 17.62f;
+  const float c = 243.12f;
+  float gamma = logf(humidity / 100.0f) + (b * temperature) / (c + temperature);
+  return (c * gamma) / (b - gamma);
+}
+
+// WMO weather code for the station readings, -1 if the temperature or humidity is missing
+inline int cydWeeWXClassifyWmo(const cydWeeWXStationReadings &r) {
+  if (isnan(r.temperature) || isnan(r.humidity) || (r.humidity <= 0.0f)) {
+    return -1;
+  }
+  float rainRate = isnan(r.rainRate) ? 0.0f : r.rainRate;
+  float pressureTrend = isnan(r.pressureTrend) ? 0.0f : r.pressureTrend;
+
+  if (rainRate > 0.0f) {
+    if (r.temperature < -2.0f) {          // Snow, rate as melted water
+      if (rainRate < 1.0f) return 71;
+      if (rainRate < 4.0f) return 73;
+      return 75;
+    }
+    if (r.temperature <= 0.5f) {          // Freezing drizzle or rain
+      if (rainRate < 0.5f) return 56;
+      if (rainRate < 2.5f) return 66;
+      return 67;
+    }
+    if (rainRate < 0.2f) return 51;       // Drizzle
+    if (rainRate < 0.5f) return 53;
+    if (rainRate < 2.5f) return 61;       // Rain
+    if (rainRate < 7.6f) return 63;
+    if (rainRate < 50.0f) return 65;
+    return 82;                            // Violent rain showers
+  }
+
+  // Fog when the air is saturated
+  float spread = r.temperature - cydWeeWXDewpoint(r.temperature, fminf(r.humidity, 100.0f));
+  if ((spread < 1.0f) && (r.humidity >= 97.0f)) {
+    return 45;
+  }
+
+  // Humidity climbs at night as the air cools, so it says less about cloud
+  float humidity = r.isDay ? r.humidity : r.humidity - 5.0f;
+  if ((humidity >= 90.0f) || (pressureTrend <= -1.0f)) {
+    return 3;                             // Overcast
+  }
+  if ((humidity >= 75.0f) || (pressureTrend <= -0.5f)) {
+    return 2;                             // Partly cloudy
+  }
+  if (humidity >= 60.0f) {
+    return 1;                             // Mainly clear
+  }
+  return 0;                               // Clear sky
+}
+
+#endif  // CYD_WEEWX_WMO
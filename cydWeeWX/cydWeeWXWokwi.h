@@ -61,4 +61,19 @@ char cydWeeWXWokwiJSON[] = "{"
                                         "\"inside humidity\": {\"value\": 48.0, \"units\": \"%\"},"
                                         "\"void_end\": null"
                                         "}"
-                        "}";
\ No newline at end of file
+                        "}";
+
+// Status line and headers for the recorded responses. The body ends when the connection closes.
+const char cydWeeWXWokwiHead[] = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n";
+
+// Open-Meteo response for the simulated station: overcast now, then the hourly codes
+const char cydWeeWXWokwiOpenMeteoJSON[] = "{"
+                            "\"latitude\": 51.5,"
+                            "\"longitude\": 0.0,"
+                            "\"current\": {\"time\": 1733050800, \"interval\": 900, \"weather_code\": 3},"
+                            "\"hourly\":"
+                                        "{"
+                                        "\"time\": [1733050800, 1733054400, 1733058000, 1733061600],"
+                                        "\"weather_code\": [3, 61, 63, 2]"
+                                        "}"
+                        "}";
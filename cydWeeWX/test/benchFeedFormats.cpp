@@ -0,0 +1,105 @@
+// **********************************************************************************
+// ** Host benchmark for the WeeWX feed formats
+// ** The same station data, the WOKWi recording of cyd_weewx.json, as the full file
+// ** parsed with the field filter, the compact feed in JSON and the compact feed in
+// ** MessagePack. For each the bytes on the wire, the parse time and the JsonDocument
+// ** memory are printed, and the readings must come out the same. Built with the
+// ** real ArduinoJson library, see CMakeLists.txt.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+#include "cydWeeWXFeedSamples.h"
+#include "cydWeeWXJsonArena.h"
+#include "cydWeeWXTest.h"
+
+#include <chrono>
+#include <math.h>
+
+#define CYD_WWX_BENCH_PARSES 20000
+
+// Value of a field in a parsed document of either format, as getWeeWXValue() reads it
+static JsonVariantConst fieldValue(const JsonDocument &doc, cydwwxfield field, bool full) {
+  const weeWXFieldKey &key = weeWXFieldKeys[(unsigned int)field];
+  if (full) {
+    return key.hasUnits ? doc[key.group][key.name]["value"] : doc[key.group][key.name];
+  }
+  return key.hasUnits ? doc[(unsigned int)field][0] : doc[(unsigned int)field];
+}
+
+// Units of a field in a parsed document of either format, as getWeeWXUnits() reads them
+static JsonVariantConst fieldUnits(const JsonDocument &doc, cydwwxfield field, bool full) {
+  const weeWXFieldKey &key = weeWXFieldKeys[(unsigned int)field];
+  return full ? doc[key.group][key.name]["units"] : doc[(unsigned int)field][1];
+}
+
+// Numbers only need to agree to the precision serializeJson wrote the compact sample with
+static bool sameValue(JsonVariantConst value, JsonVariantConst expected) {
+  if (expected.is<const char *>()) {
+    return value.is<const char *>() && (strcmp(value.as<const char *>(), expected.as<const char *>()) == 0);
+  }
+  if (expected.isNull()) {
+    return value.isNull();
+  }
+  double difference = fabs(value.as<double>() - expected.as<double>());
+  return difference <= 1e-6 * fmax(1.0, fabs(expected.as<double>()));
+}
+
+static DeserializationError parse(JsonDocument &doc, const char *input, size_t length, bool msgPack, JsonDocument *filter) {
+  if (msgPack) {
+    return deserializeMsgPack(doc, input, length);
+  } else if (filter != nullptr) {
+    return deserializeJson(doc, input, length, DeserializationOption::Filter(*filter));
+  }
+  return deserializeJson(doc, input, length);
+}
+
+static void benchmark(const char *name, const char *input, size_t length, bool msgPack, JsonDocument *filter, JsonDocument &reference) {
+  cydWeeWXCountingAllocator allocator;
+  {
+    JsonDocument doc(&allocator);
+    CHECK(!parse(doc, input, length, msgPack, filter));
+    printf("%-26s %6zu bytes, document %5zu bytes, peak while parsing %5zu bytes, ", name, length, allocator.currentSize, allocator.peakSize);
+
+    // Every field the display uses reads the same as from the full file, with the same units
+    for (int field = 0; field < (int)cydwwxfield::MAX_FIELDS; field++) {
+      if ((cydwwxfield)field == cydwwxfield::GENERATION_EPOCH) {
+        continue;  // Only in the compact samples
+      }
+      bool full = filter != nullptr;
+      JsonVariantConst value = fieldValue(doc, (cydwwxfield)field, full);
+      JsonVariantConst expected = fieldValue(reference, (cydwwxfield)field, true);
+      bool same = sameValue(value, expected)
+        && sameValue(fieldUnits(doc, (cydwwxfield)field, full), fieldUnits(reference, (cydwwxfield)field, true));
+      if (!CHECK(same)) {
+        printf("\n  %s field %d differs\n", name, field);
+      }
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < CYD_WWX_BENCH_PARSES; index++) {
+    JsonDocument doc(&allocator);
+    parse(doc, input, length, msgPack, filter);
+  }
+  double parseTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_BENCH_PARSES;
+  printf("%.1f usec to parse\n", parseTime);
+}
+
+int main() {
+  static cydWeeWXFeedSamples samples;
+  if (!CHECK(buildFeedSamples(samples))) {
+    return cydWeeWXTestResult();
+  }
+  JsonDocument filter;
+  buildWeeWXFilter(filter);
+  JsonDocument reference;
+  deserializeJson(reference, samples.fullJSON, samples.fullJSONLength);
+
+  benchmark("Full JSON, filtered", samples.fullJSON, samples.fullJSONLength, false, &filter, reference);
+  benchmark("Compact JSON", samples.compactJSON, samples.compactJSONLength, false, nullptr, reference);
+  benchmark("Compact MessagePack", samples.compactMsgPack, samples.compactMsgPackLength, true, nullptr, reference);
+  return cydWeeWXTestResult();
+}
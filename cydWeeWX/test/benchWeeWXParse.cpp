@@ -0,0 +1,132 @@
+// **********************************************************************************
+// ** Host benchmark for the ways of getting a WeeWX response into a JsonDocument
+// ** The WOKWi recording of cyd_weewx.json arrives in TCP sized segments and is
+// ** parsed with the field filter:
+// **   String copy: appended to a string, as http.getString() did, then parsed
+// **   Stream:      parsed from the segments as they arrive
+// **   Body buffer: copied into a static buffer, as cydWeeWXFetch does, then parsed
+// ** The heap each needs at its peak and the time per poll are printed. Built with
+// ** the real ArduinoJson library, see CMakeLists.txt.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+#include "cydWeeWXFields.h"
+#include "cydWeeWXJsonArena.h"
+#include "cydWeeWXWokwi.h"
+#include "cydWeeWXTest.h"
+
+#include <chrono>
+#include <math.h>
+#include <string>
+
+#define CYD_WWX_BENCH_POLLS 20000
+#define CYD_WWX_BENCH_SEGMENT 1436            // TCP payload of one Ethernet frame
+
+// Hands out the response a segment at a time, like the socket stream
+class cydWeeWXSegmentReader {
+  public:
+    cydWeeWXSegmentReader(const char *data, size_t length) : data(data), length(length) {}
+
+    int read() {
+      return (position < length) ? (uint8_t)data[position++] : -1;
+    }
+
+    size_t readBytes(char *buffer, size_t count) {
+      size_t segmentEnd = (position / CYD_WWX_BENCH_SEGMENT + 1) * CYD_WWX_BENCH_SEGMENT;
+      size_t available = ((segmentEnd < length) ? segmentEnd : length) - position;
+      if (count > available) {
+        count = available;
+      }
+      memcpy(buffer, data + position, count);
+      position += count;
+      return count;
+    }
+
+  private:
+    const char *data;
+    size_t length;
+    size_t position = 0;
+};
+
+static char weeWXBody[CYD_WWX_WEEWX_BODY_BUFFER_SIZE];
+
+struct cydWeeWXParseResult {
+  size_t peakHeap = 0;
+  double temperature = 0;
+  bool parsed = false;
+};
+
+static cydWeeWXParseResult parseStringCopy(const char *data, size_t length, JsonDocument &filter) {
+  cydWeeWXParseResult result;
+  cydWeeWXCountingAllocator allocator;
+  std::string payload;
+  cydWeeWXSegmentReader reader(data, length);
+  char segment[CYD_WWX_BENCH_SEGMENT];
+  size_t count;
+  while ((count = reader.readBytes(segment, sizeof(segment))) > 0) {
+    payload.append(segment, count);
+  }
+  JsonDocument doc(&allocator);
+  result.parsed = !deserializeJson(doc, payload.data(), payload.size(), DeserializationOption::Filter(filter));
+  result.peakHeap = payload.capacity() + allocator.peakSize;
+  result.temperature = doc["current"]["temperature"]["value"].as<double>();
+  return result;
+}
+
+static cydWeeWXParseResult parseStream(const char *data, size_t length, JsonDocument &filter) {
+  cydWeeWXParseResult result;
+  cydWeeWXCountingAllocator allocator;
+  cydWeeWXSegmentReader reader(data, length);
+  JsonDocument doc(&allocator);
+  result.parsed = !deserializeJson(doc, reader, DeserializationOption::Filter(filter));
+  result.peakHeap = allocator.peakSize;
+  result.temperature = doc["current"]["temperature"]["value"].as<double>();
+  return result;
+}
+
+static cydWeeWXParseResult parseBodyBuffer(const char *data, size_t length, JsonDocument &filter) {
+  cydWeeWXParseResult result;
+  cydWeeWXCountingAllocator allocator;
+  cydWeeWXSegmentReader reader(data, length);
+  size_t bodyLength = 0;
+  size_t count;
+  while ((count = reader.readBytes(weeWXBody + bodyLength, sizeof(weeWXBody) - 1 - bodyLength)) > 0) {
+    bodyLength += count;
+  }
+  weeWXBody[bodyLength] = '\0';
+  JsonDocument doc(&allocator);
+  result.parsed = !deserializeJson(doc, (const char *)weeWXBody, bodyLength, DeserializationOption::Filter(filter));
+  result.peakHeap = allocator.peakSize;
+  result.temperature = doc["current"]["temperature"]["value"].as<double>();
+  return result;
+}
+
+typedef cydWeeWXParseResult (*cydWeeWXParseMethod)(const char *data, size_t length, JsonDocument &filter);
+
+static void benchmark(const char *name, cydWeeWXParseMethod method, const char *data, size_t length, JsonDocument &filter) {
+  cydWeeWXParseResult result = method(data, length, filter);
+  CHECK(result.parsed);
+  CHECK(fabs(result.temperature - 1.546666666666666) < 1e-9);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int poll = 0; poll < CYD_WWX_BENCH_POLLS; poll++) {
+    method(data, length, filter);
+  }
+  double pollTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_BENCH_POLLS;
+  printf("%-12s peak heap %6zu bytes, %6.1f usec per poll\n", name, result.peakHeap, pollTime);
+}
+
+int main() {
+  JsonDocument filter;
+  buildWeeWXFilter(filter);
+  size_t length = strlen(cydWeeWXWokwiJSON);
+  printf("WeeWX response of %zu bytes in %d byte segments\n", length, CYD_WWX_BENCH_SEGMENT);
+
+  benchmark("String copy", parseStringCopy, cydWeeWXWokwiJSON, length, filter);
+  benchmark("Stream", parseStream, cydWeeWXWokwiJSON, length, filter);
+  benchmark("Body buffer", parseBodyBuffer, cydWeeWXWokwiJSON, length, filter);
+  return cydWeeWXTestResult();
+}
@@ -0,0 +1,27 @@
+# **********************************************************************************
+# ** Code size check for the cydWeeWX host build
+# ** Sums the text (code and read-only data) of the object files given in OBJECTS
+# ** and fails if it is over BUDGET bytes:
+# **   cmake -DSIZE=size -DNAME=name -DOBJECTS="a.o;b.o" -DBUDGET=bytes -P checkCodeSize.cmake
+# **********************************************************************************
+# ** Project details at https://github.com/hcomet/cydWeeWX
+# ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+# **********************************************************************************
+
+execute_process(COMMAND ${SIZE} ${OBJECTS} OUTPUT_VARIABLE sizeOutput RESULT_VARIABLE sizeResult)
+if(NOT sizeResult EQUAL 0)
+  message(FATAL_ERROR "${SIZE} failed on ${OBJECTS}")
+endif()
+
+set(text 0)
+string(REPLACE "\n" ";" sizeLines "${sizeOutput}")
+foreach(line IN LISTS sizeLines)
+  if(line MATCHES "^ *([0-9]+)[ \t]")
+    math(EXPR text "${text} + ${CMAKE_MATCH_1}")
+  endif()
+endforeach()
+
+message("${NAME}: ${text} bytes of text at -Os, budget ${BUDGET} bytes")
+if(text GREATER BUDGET)
+  message(FATAL_ERROR "${NAME} code size ${text} bytes is over the budget of ${BUDGET} bytes")
+endif()
@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+# **********************************************************************************
+# ** Feature flag check for the cydWeeWX sketch
+# ** Runs the sketch through the C preprocessor with no flags, each flag, each pair of
+# ** flags and all flags set, and reports any function or global that is used in a
+# ** combination which does not define it. Needs cpp (gcc) on the path.
+# **********************************************************************************
+# ** Project details at https://github.com/hcomet/cydWeeWX
+# ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+# **********************************************************************************
+
+import itertools
+import os
+import re
+import subprocess
+import sys
+
+sketch = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'cydWeeWX.ino')
+source = open(sketch).read()
+flags = sorted(set(re.findall(r'(?:#ifn?def\s+|defined\s*\(?\s*)(CYD_WWX_\w+)', source)))
+# Includes are dropped so only the sketch's own conditionals are tested
+body = '\n'.join('' if line.lstrip().startswith('#include') else line for line in source.split('\n'))
+
+functionPattern = re.compile(r'^(?!return\b|else\b)[A-Za-z_][\w:<>,\s\*&]*?[\s\*&](\w+)\s*\([^;{]*\)\s*(?:const\s*)?\{', re.M)
+globalPattern = re.compile(r'^(?!return\b|else\b|typedef\b|using\b)(?:static\s+|const\s+|volatile\s+|RTC_NOINIT_ATTR\s+|alignas\(\w+\)\s+)*'
+                           r'[A-Za-z_][\w:<>,]*\s+\**(\w+)\s*(?:\[[^\]]*\])?\s*(?:=[^;]*)?;', re.M)
+
+
+def preprocess(enabled):
+    text = subprocess.run(['cpp', '-P', '-w', '-x', 'c++'] + ['-D' + flag for flag in enabled],
+                          input=body, capture_output=True, text=True, check=True).stdout
+    return text, set(functionPattern.findall(text)) | set(globalPattern.findall(text))
+
+
+combinations = [()] + list(itertools.combinations(flags, 1)) + list(itertools.combinations(flags, 2)) + [tuple(flags)]
+results = {enabled: preprocess(enabled) for enabled in combinations}
+known = set().union(*(defined for _, defined in results.values()))
+
+failures = 0
+for enabled, (text, defined) in results.items():
+    used = set(re.findall(r'\b\w+\b', text))
+    missing = sorted(name for name in known - defined if name in used)
+    if missing:
+        failures += 1
+        print('+'.join(enabled) or '(no flags)', 'uses undefined', ', '.join(missing))
+print(len(combinations), 'flag combinations checked,', failures, 'failed')
+sys.exit(1 if failures else 0)
@@ -0,0 +1,59 @@
+// **********************************************************************************
+// ** Code for the cydWeeWX code size checks
+// ** Built at -Os once for each CYD_WWX_SIZE_* define with just the functions the
+// ** firmware calls from one header, so checkCodeSize.cmake can measure them alone.
+// ** Sizes are for the host compiler, so they follow changes to the code rather than
+// ** giving the ESP32 flash use.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+
+#ifdef CYD_WWX_SIZE_SNAPSHOT
+#include "cydWeeWXSnapshot.h"
+
+// The field sizes the network task writes most
+bool cydWeeWXSizeSnapshot(cydWeeWXSnapshot &snapshot, const char *text) {
+  return setSnapshotText(snapshot.screenHeader, text) | setSnapshotText(snapshot.location, text)
+    | setSnapshotText(snapshot.reading(cydwwxsensor::TEMPERATURE).value, text);
+}
+#endif  // CYD_WWX_SIZE_SNAPSHOT
+
+#ifdef CYD_WWX_SIZE_JSON_ARENA
+#include "cydWeeWXJsonArena.h"
+
+// The arena allocator as a JsonDocument calls it, through the Allocator interface
+cydWeeWXArenaAllocator cydWeeWXSizeArena;
+
+ArduinoJson::Allocator *cydWeeWXSizeJsonArena() {
+  cydWeeWXSizeArena.reset();
+  return &cydWeeWXSizeArena;
+}
+#endif  // CYD_WWX_SIZE_JSON_ARENA
+
+#ifdef CYD_WWX_SIZE_FORMAT
+#include "cydWeeWXFormat.h"
+
+// Every reading goes through the one function
+int cydWeeWXSizeFormat(char *buffer, size_t size, double value, int width, int decimals) {
+  return formatFixed(buffer, size, value, width, decimals);
+}
+#endif  // CYD_WWX_SIZE_FORMAT
+
+#ifdef CYD_WWX_SIZE_TIME
+#include "cydWeeWXTime.h"
+
+// The report time as processWeeWXResponse() reads it, and the almanac and dimmer times
+cydWeeWXLocalTime cydWeeWXSizeTime(const char *report, int64_t epoch, cydWeeWXTimestamp &time) {
+  if (parseWeeWXTimestamp(report, time)) {
+    setUtcOffsetFromEpoch(time, epoch);
+  }
+  return getLocalTime(time.localTime());
+}
+
+int cydWeeWXSizeTimeOfDay(const char *almanac, const char *&clock) {
+  return parseAlmanacTime(almanac) + parseClockTime(clock);
+}
+#endif  // CYD_WWX_SIZE_TIME
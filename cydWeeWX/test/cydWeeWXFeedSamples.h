@@ -0,0 +1,61 @@
+// **********************************************************************************
+// ** Include for the cydWeeWX host tools that need the real ArduinoJson library
+// ** The WOKWi recording of the full WeeWX file is the sample station data. The
+// ** compact feed for the same data is built from it the way
+// ** cyd_weewx_compact.json.tmpl lays it out, in JSON and in MessagePack.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_FEED_SAMPLES
+#define CYD_WEEWX_FEED_SAMPLES
+
+#include <string.h>
+#include <ArduinoJson.h>
+#include "cydWeeWXFields.h"
+#include "cydWeeWXWokwi.h"
+
+#define CYD_WWX_SAMPLE_EPOCH 1732624800       // Report time of the WOKWi recording, which has no epoch field
+#define CYD_WWX_SAMPLE_FEED_SIZE 4096         // Room for either compact sample
+
+// The WeeWX responses the firmware parses, for the same station data
+struct cydWeeWXFeedSamples {
+  const char *fullJSON = cydWeeWXWokwiJSON;
+  size_t fullJSONLength = strlen(cydWeeWXWokwiJSON);
+  char compactJSON[CYD_WWX_SAMPLE_FEED_SIZE];
+  size_t compactJSONLength = 0;
+  char compactMsgPack[CYD_WWX_SAMPLE_FEED_SIZE];
+  size_t compactMsgPackLength = 0;
+};
+
+// Fill in the compact feed samples from the full file. Returns false if the full file does not parse.
+inline bool buildFeedSamples(cydWeeWXFeedSamples &samples) {
+  JsonDocument full;
+  if (deserializeJson(full, samples.fullJSON, samples.fullJSONLength)) {
+    return false;
+  }
+  JsonDocument compact;
+  JsonArray fields = compact.to<JsonArray>();
+  for (int field = 0; field < (int)cydwwxfield::MAX_FIELDS; field++) {
+    const weeWXFieldKey &key = weeWXFieldKeys[field];
+    JsonVariantConst value = full[key.group][key.name];
+    if ((cydwwxfield)field == cydwwxfield::GENERATION_EPOCH) {
+      fields.add(CYD_WWX_SAMPLE_EPOCH);
+    } else if (!key.hasUnits) {
+      fields.add(value);
+    } else if (value.isNull()) {
+      fields.add(nullptr);
+    } else {
+      JsonArray reading = fields.add<JsonArray>();
+      reading.add(value["value"]);
+      reading.add(value["units"]);
+    }
+  }
+  samples.compactJSONLength = serializeJson(compact, samples.compactJSON, sizeof(samples.compactJSON));
+  samples.compactMsgPackLength = serializeMsgPack(compact, samples.compactMsgPack, sizeof(samples.compactMsgPack));
+  return (samples.compactJSONLength > 0) && (samples.compactJSONLength < sizeof(samples.compactJSON))
+    && (samples.compactMsgPackLength > 0) && (samples.compactMsgPackLength < sizeof(samples.compactMsgPack));
+}
+
+#endif  // CYD_WEEWX_FEED_SAMPLES
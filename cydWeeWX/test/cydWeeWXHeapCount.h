@@ -0,0 +1,46 @@
+// **********************************************************************************
+// ** Include for the cydWeeWX host tests that count heap calls
+// ** malloc, calloc, realloc and free are replaced for the whole process and passed
+// ** on to glibc, counting each call in cydWeeWXHeapCalls. Include it in the one
+// ** source file of a test only.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_HEAP_COUNT
+#define CYD_WEEWX_HEAP_COUNT
+
+#include <stddef.h>
+
+// Every heap call in the process goes through these (glibc)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+static size_t cydWeeWXHeapCalls = 0;
+
+extern "C" void *malloc(size_t size) {
+  cydWeeWXHeapCalls += 1;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+  cydWeeWXHeapCalls += 1;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+  cydWeeWXHeapCalls += 1;
+  return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr) {
+  if (ptr != nullptr) {
+    cydWeeWXHeapCalls += 1;
+  }
+  __libc_free(ptr);
+}
+
+#endif  // CYD_WEEWX_HEAP_COUNT
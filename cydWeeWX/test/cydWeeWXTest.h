@@ -0,0 +1,46 @@
+// **********************************************************************************
+// ** Include for the cydWeeWX host tests with the check macros
+// ** A failed check prints where it failed and the test carries on, so one run shows
+// ** every failure. main() returns cydWeeWXTestResult().
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_TEST
+#define CYD_WEEWX_TEST
+
+#include <stdio.h>
+#include <string.h>
+
+inline int cydWeeWXTestChecks = 0;
+inline int cydWeeWXTestFailures = 0;
+
+#define CHECK(condition) cydWeeWXCheck((condition), #condition, __FILE__, __LINE__)
+#define CHECK_TEXT(actual, expected) cydWeeWXCheckText((actual), (expected), #actual, __FILE__, __LINE__)
+
+inline bool cydWeeWXCheck(bool passed, const char *condition, const char *file, int line) {
+  cydWeeWXTestChecks += 1;
+  if (!passed) {
+    cydWeeWXTestFailures += 1;
+    printf("%s:%d: check failed: %s\n", file, line, condition);
+  }
+  return passed;
+}
+
+inline bool cydWeeWXCheckText(const char *actual, const char *expected, const char *name, const char *file, int line) {
+  cydWeeWXTestChecks += 1;
+  if (strcmp(actual, expected) != 0) {
+    cydWeeWXTestFailures += 1;
+    printf("%s:%d: %s is \"%s\", expected \"%s\"\n", file, line, name, actual, expected);
+    return false;
+  }
+  return true;
+}
+
+inline int cydWeeWXTestResult() {
+  printf("%d checks, %d failed\n", cydWeeWXTestChecks, cydWeeWXTestFailures);
+  return (cydWeeWXTestFailures == 0) ? 0 : 1;
+}
+
+#endif  // CYD_WEEWX_TEST
@@ -0,0 +1,119 @@
+// **********************************************************************************
+// ** Desktop host stand-in for the parts of the Arduino core used by the cydWeeWX
+// ** headers under test: String, IPAddress and Print, with Serial going to stderr, and
+// ** strlcpy, which newlib has and glibc only has from 2.38.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_HOST_ARDUINO
+#define CYD_WEEWX_HOST_ARDUINO
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+inline size_t strlcpy(char *destination, const char *source, size_t size) {
+  size_t length = strlen(source);
+  if (size > 0) {
+    size_t count = (length < size - 1) ? length : size - 1;
+    memcpy(destination, source, count);
+    destination[count] = '\0';
+  }
+  return length;
+}
+#endif  // __GLIBC__ < 2.38
+
+class String {
+  public:
+    String() {}
+    String(const char *text) : text(text) {}
+    String(const std::string &text) : text(text) {}
+    explicit String(int value) : text(std::to_string(value)) {}
+    explicit String(unsigned int value) : text(std::to_string(value)) {}
+    explicit String(long value) : text(std::to_string(value)) {}
+    explicit String(unsigned long value) : text(std::to_string(value)) {}
+
+    const char *c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.size(); }
+    bool isEmpty() const { return text.empty(); }
+    bool equals(const String &other) const { return text == other.text; }
+    bool operator==(const String &other) const { return text == other.text; }
+    bool startsWith(const char *prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+    long toInt() const { return atol(text.c_str()); }
+
+    int indexOf(char c, unsigned int from = 0) const {
+      size_t index = text.find(c, from);
+      return (index == std::string::npos) ? -1 : (int)index;
+    }
+
+    String substring(unsigned int from) const { return String(text.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const { return String(text.substr(from, to - from)); }
+
+    String &operator+=(const String &other) { text += other.text; return *this; }
+    String &operator+=(const char *other) { text += other; return *this; }
+    friend String operator+(const String &a, const String &b) { return String(a.text + b.text); }
+    friend String operator+(const String &a, const char *b) { return String(a.text + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b.text); }
+
+  private:
+    std::string text;
+};
+
+class IPAddress {
+  public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : value(((uint32_t)a << 24) | ((uint32_t)b << 16) | ((uint32_t)c << 8) | d) {}
+
+    bool fromString(const String &text) {
+      return fromString(text.c_str());
+    }
+
+    bool fromString(const char *text) {
+      unsigned int a, b, c, d;
+      char end;
+      if ((sscanf(text, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4) || (a > 255) || (b > 255) || (c > 255) || (d > 255)) {
+        return false;
+      }
+      *this = IPAddress(a, b, c, d);
+      return true;
+    }
+
+    String toString() const {
+      char text[16];
+      snprintf(text, sizeof(text), "%u.%u.%u.%u", value >> 24, (value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF);
+      return String(text);
+    }
+
+    uint8_t operator[](int index) const { return (value >> (8 * (3 - index))) & 0xFF; }
+    bool operator==(const IPAddress &other) const { return value == other.value; }
+    bool operator!=(const IPAddress &other) const { return value != other.value; }
+
+  private:
+    uint32_t value = 0;
+};
+
+class Print {
+  public:
+    size_t print(const String &text) { return fputs(text.c_str(), stderr); }
+    size_t print(const char *text) { return fputs(text, stderr); }
+    size_t print(char c) { return fputc(c, stderr); }
+    size_t print(bool value) { return fprintf(stderr, "%d", value); }
+    size_t print(int value) { return fprintf(stderr, "%d", value); }
+    size_t print(unsigned int value) { return fprintf(stderr, "%u", value); }
+    size_t print(long value) { return fprintf(stderr, "%ld", value); }
+    size_t print(unsigned long value) { return fprintf(stderr, "%lu", value); }
+    size_t print(long long value) { return fprintf(stderr, "%lld", value); }
+    size_t print(unsigned long long value) { return fprintf(stderr, "%llu", value); }
+    size_t print(double value) { return fprintf(stderr, "%.2f", value); }
+};
+
+inline Print Serial;
+
+#endif  // CYD_WEEWX_HOST_ARDUINO
@@ -0,0 +1,7 @@
+// **********************************************************************************
+// ** Desktop host stand-in for the TFT_eSPI User_Setup.h so cydWeeWXDefines.h can be
+// ** included by the tests. No display driver is selected.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
@@ -0,0 +1,32 @@
+// **********************************************************************************
+// ** Desktop host stand-in for the Arduino WiFi library. Only the name lookup used by
+// ** cydWeeWXResolver is there, and tests set what it returns.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_HOST_WIFI
+#define CYD_WEEWX_HOST_WIFI
+
+#include <Arduino.h>
+
+class WiFiClass {
+  public:
+    IPAddress lookupAddress = IPAddress(192, 168, 1, 10);   // Address every lookup finds
+    bool lookupFails = false;                               // Every lookup fails
+    uint32_t lookupCount = 0;                               // Lookups made
+
+    int hostByName(const char *host, IPAddress &address) {
+      lookupCount += 1;
+      if (lookupFails) {
+        return 0;
+      }
+      address = lookupAddress;
+      return 1;
+    }
+};
+
+inline WiFiClass WiFi;
+
+#endif  // CYD_WEEWX_HOST_WIFI
@@ -0,0 +1,30 @@
+// **********************************************************************************
+// ** Desktop host stand-in for ArduinoJson with just the Allocator interface, so the
+// ** cydWeeWX allocators build without the library. It is in its own folder, which
+// ** is only searched when CYD_WWX_ARDUINOJSON_DIR does not give the real library.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_HOST_ARDUINOJSON
+#define CYD_WEEWX_HOST_ARDUINOJSON
+
+#include <stddef.h>
+
+namespace ArduinoJson {
+
+// Same interface as the ArduinoJson 7 Allocator
+class Allocator {
+  public:
+    virtual void* allocate(size_t size) = 0;
+    virtual void deallocate(void* ptr) = 0;
+    virtual void* reallocate(void* ptr, size_t new_size) = 0;
+
+  protected:
+    ~Allocator() = default;
+};
+
+}  // namespace ArduinoJson
+
+#endif  // CYD_WEEWX_HOST_ARDUINOJSON
@@ -0,0 +1,70 @@
+// **********************************************************************************
+// ** Desktop host stand-in for the miniz tinfl inflater in the ESP32 ROM, built on
+// ** zlib. Only what cydWeeWXFetch uses is there: raw deflate data into a non-wrapping
+// ** output buffer.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#ifndef CYD_WEEWX_HOST_MINIZ
+#define CYD_WEEWX_HOST_MINIZ
+
+#include <stddef.h>
+#include <string.h>
+#include <zlib.h>
+
+typedef unsigned char mz_uint8;
+
+struct tinfl_decompressor {
+  z_stream stream;
+  bool started = false;
+
+  ~tinfl_decompressor() {
+    if (started) {
+      inflateEnd(&stream);
+    }
+  }
+};
+
+typedef enum {
+  TINFL_STATUS_FAILED = -1,
+  TINFL_STATUS_DONE = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+enum {
+  TINFL_FLAG_HAS_MORE_INPUT = 2,
+  TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4
+};
+
+inline void tinfl_init(tinfl_decompressor *inflater) {
+  if (inflater->started) {
+    inflateEnd(&inflater->stream);
+  }
+  memset(&inflater->stream, 0, sizeof(inflater->stream));
+  inflateInit2(&inflater->stream, -15);
+  inflater->started = true;
+}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor *inflater, const mz_uint8 *in, size_t *inSize, mz_uint8 *outStart,
+                                     mz_uint8 *out, size_t *outSize, int flags) {
+  z_stream &stream = inflater->stream;
+  stream.next_in = (Bytef *)in;
+  stream.avail_in = *inSize;
+  stream.next_out = out;
+  stream.avail_out = *outSize;
+  int result = inflate(&stream, Z_NO_FLUSH);
+  *inSize -= stream.avail_in;
+  *outSize -= stream.avail_out;
+  if (result == Z_STREAM_END) {
+    return TINFL_STATUS_DONE;
+  }
+  if ((result != Z_OK) && (result != Z_BUF_ERROR)) {
+    return TINFL_STATUS_FAILED;
+  }
+  return (stream.avail_out == 0) ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
+
+#endif  // CYD_WEEWX_HOST_MINIZ
@@ -0,0 +1,95 @@
+// **********************************************************************************
+// ** Measures the JsonDocument memory of every query response cydWeeWX parses into
+// ** the JSON arena, with cydWeeWXCountingAllocator and the real ArduinoJson library:
+// ** the WOKWi WeeWX file with the field filter (and without it when
+// ** CYD_WWX_WEEWX_FILTER_FIELDS is off), the compact feed built from it in JSON and
+// ** MessagePack, and the WOKWi Open-Meteo response. Fails if CYD_WWX_JSON_ARENA_SIZE
+// ** is not CYD_WWX_ARENA_MARGIN times the largest peak, or if any of them overflows
+// ** the arena or calls malloc, realloc or free while parsing into it, and prints the
+// ** size to use.
+// ** Pointers are 8 bytes here and 4 on the ESP32, so the peaks are larger than on
+// ** the device and the size is on the safe side.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+#include "cydWeeWXFeedSamples.h"
+#include "cydWeeWXHeapCount.h"
+#include "cydWeeWXJsonArena.h"
+#include "cydWeeWXTest.h"
+
+#define CYD_WWX_ARENA_MARGIN 1.5              // For longer location names, units and Open-Meteo responses than the samples
+#define CYD_WWX_ARENA_ROUNDING 1024           // Arena sizes are whole KB
+
+static cydWeeWXArenaAllocator arena;
+static size_t largestPeak = 0;
+
+// Parse one response the way the firmware does and report what its document needed
+static void measure(const char *name, const char *input, size_t length, bool msgPack, JsonDocument *filter) {
+  cydWeeWXCountingAllocator counting;
+  DeserializationError error;
+  {
+    JsonDocument doc(&counting);
+    if (msgPack) {
+      error = deserializeMsgPack(doc, input, length);
+    } else if (filter != nullptr) {
+      error = deserializeJson(doc, input, length, DeserializationOption::Filter(*filter));
+    } else {
+      error = deserializeJson(doc, input, length);
+    }
+    printf("%-28s %6zu bytes in, document %5zu bytes, peak while parsing %5zu bytes\n", name, length, counting.currentSize, counting.peakSize);
+  }
+  CHECK_TEXT(error.c_str(), "Ok");
+  CHECK(counting.currentSize == 0);
+  if (counting.peakSize > largestPeak) {
+    largestPeak = counting.peakSize;
+  }
+
+  // The same parse in the arena must not spill over to the heap, or touch it any other way
+  arena.reset();
+  arena.overflowCount = 0;
+  size_t before = cydWeeWXHeapCalls;
+  {
+    JsonDocument doc(&arena);
+    if (msgPack) {
+      deserializeMsgPack(doc, input, length);
+    } else if (filter != nullptr) {
+      deserializeJson(doc, input, length, DeserializationOption::Filter(*filter));
+    } else {
+      deserializeJson(doc, input, length);
+    }
+  }
+  size_t heapCalls = cydWeeWXHeapCalls - before;
+  if (!CHECK(arena.overflowCount == 0)) {
+    printf("  %s overflows the %d byte arena\n", name, CYD_WWX_JSON_ARENA_SIZE);
+  }
+  if (!CHECK(heapCalls == 0)) {
+    printf("  %s made %zu heap calls while parsing into the arena\n", name, heapCalls);
+  }
+}
+
+int main() {
+  static cydWeeWXFeedSamples samples;
+  if (!CHECK(buildFeedSamples(samples))) {
+    return cydWeeWXTestResult();
+  }
+  JsonDocument filter;
+  buildWeeWXFilter(filter);
+
+  measure("WeeWX full JSON, filtered", samples.fullJSON, samples.fullJSONLength, false, &filter);
+#ifndef CYD_WWX_WEEWX_FILTER_FIELDS
+  measure("WeeWX full JSON", samples.fullJSON, samples.fullJSONLength, false, nullptr);
+#endif  // CYD_WWX_WEEWX_FILTER_FIELDS
+  measure("WeeWX compact JSON", samples.compactJSON, samples.compactJSONLength, false, nullptr);
+  measure("WeeWX compact MessagePack", samples.compactMsgPack, samples.compactMsgPackLength, true, nullptr);
+  measure("Open-Meteo", cydWeeWXWokwiOpenMeteoJSON, strlen(cydWeeWXWokwiOpenMeteoJSON), false, nullptr);
+
+  size_t needed = (size_t)(largestPeak * CYD_WWX_ARENA_MARGIN);
+  needed = (needed + CYD_WWX_ARENA_ROUNDING - 1) / CYD_WWX_ARENA_ROUNDING * CYD_WWX_ARENA_ROUNDING;
+  printf("Largest peak %zu bytes. With a margin of %.1f: CYD_WWX_JSON_ARENA_SIZE %zu (set to %d).\n",
+         largestPeak, CYD_WWX_ARENA_MARGIN, needed, CYD_WWX_JSON_ARENA_SIZE);
+  CHECK((size_t)CYD_WWX_JSON_ARENA_SIZE >= needed);
+  return cydWeeWXTestResult();
+}
@@ -0,0 +1,528 @@
+// **********************************************************************************
+// ** Host test for cydWeeWXFetch and the fixture and fault transports
+// ** Responses are replayed with each body framing the WeeWX server and Open-Meteo
+// ** use (Content-Length, chunked, until close and gzip), trickled in and cut short
+// ** with the fault transport, and sent over a kept connection the server has closed.
+// ** Every heap call is counted over many polls to show a fetch makes none.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+#include "cydWeeWXFetch.h"
+#include "cydWeeWXTest.h"
+#include "cydWeeWXHeapCount.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define CYD_WWX_TEST_POLLS 1000
+
+// Server that answers each request on a connection with the next response and keeps the
+// connection open between them unless told to close it, like the WeeWX server with keep-alive.
+class cydWeeWXScriptTransport : public cydWeeWXTransport {
+  public:
+    struct Response {
+      std::string text;
+      bool closeAfter;                    // Server closes the connection after the response
+    };
+
+    std::vector<Response> responses;
+    size_t nextResponse = 0;
+    int openCount = 0;
+    std::string lastRequest;
+
+    // The server drops the idle connection without the client noticing until it is used
+    void closeIdleConnection() {
+      serverClosed = true;
+    }
+
+    bool open(const char *host, uint16_t port, bool secure) override {
+      opened = true;
+      serverClosed = false;
+      openCount += 1;
+      pending.clear();
+      position = 0;
+      return true;
+    }
+
+    int connect() override {
+      return CYD_WWX_TRANSPORT_CONNECTED;
+    }
+
+    ssize_t write(const char *data, size_t length) override {
+      if (!serverClosed && (position >= pending.size())) {
+        lastRequest.clear();
+      }
+      lastRequest.append(data, length);
+      if (!serverClosed && (lastRequest.find("\r\n\r\n") != std::string::npos) && (nextResponse < responses.size())) {
+        pending = responses[nextResponse].text;
+        closeAfter = responses[nextResponse].closeAfter;
+        position = 0;
+        nextResponse += 1;
+      }
+      return length;
+    }
+
+    ssize_t read(uint8_t *data, size_t length) override {
+      if (serverClosed) {
+        return 0;
+      }
+      if (position >= pending.size()) {
+        if (closeAfter && !pending.empty()) {
+          return 0;
+        }
+        return CYD_WWX_TRANSPORT_WOULD_BLOCK;
+      }
+      size_t count = std::min(length, pending.size() - position);
+      memcpy(data, pending.data() + position, count);
+      position += count;
+      return count;
+    }
+
+    void close() override {
+      opened = false;
+    }
+
+    bool isOpen() override {
+      return opened;
+    }
+
+    bool needsAddress() override {
+      return false;
+    }
+
+  private:
+    bool opened = false;
+    bool serverClosed = false;
+    bool closeAfter = false;
+    std::string pending;
+    size_t position = 0;
+};
+
+// Transport that connects and then never sends anything
+class cydWeeWXSilentTransport : public cydWeeWXTransport {
+  public:
+    bool open(const char *host, uint16_t port, bool secure) override { opened = true; return true; }
+    int connect() override { return CYD_WWX_TRANSPORT_CONNECTED; }
+    ssize_t write(const char *data, size_t length) override { return length; }
+    ssize_t read(uint8_t *data, size_t length) override { return CYD_WWX_TRANSPORT_WOULD_BLOCK; }
+    void close() override { opened = false; }
+    bool isOpen() override { return opened; }
+    bool needsAddress() override { return false; }
+
+  private:
+    bool opened = false;
+};
+
+static char body[4096];
+static cydWeeWXFetch fetch("Test", body, sizeof(body));
+
+// Run a fetch to the end. Returns false if it failed.
+static bool runFetch(const char *url = "http://weewx.local/cydweewx.json", bool keepAlive = false) {
+  if (!CHECK(fetch.begin(url, "", keepAlive))) {
+    return false;
+  }
+  int steps = 0;
+  while (fetch.step() && (steps < 1000000)) {
+    steps += 1;
+  }
+  CHECK(!fetch.isBusy());
+  return !fetch.failed();
+}
+
+// A WeeWX like JSON document spanning several read slices
+static std::string makeDocument() {
+  std::string document = "{\"generation\": {\"time\": \"2024-11-26T12:40:00-0500\"}, \"current\": {";
+  for (int field = 0; document.size() < 3000; field++) {
+    document += "\"field" + std::to_string(field) + "\": {\"value\": \"" + std::to_string(field * 1.25) + "\", \"units\": \"mbar\"}, ";
+  }
+  document += "\"end\": true}}";
+  return document;
+}
+
+// gzip encode text. name, extra, comment and a header CRC are added when given so every header field is skipped.
+static std::string gzip(const std::string &text, const char *name = nullptr, const char *extra = nullptr, const char *comment = nullptr,
+                        bool headerCrc = false) {
+  z_stream stream = {};
+  deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+  gz_header header = {};
+  header.name = (Bytef *)name;
+  header.extra = (Bytef *)extra;
+  header.extra_len = (extra != nullptr) ? strlen(extra) : 0;
+  header.comment = (Bytef *)comment;
+  header.hcrc = headerCrc;
+  deflateSetHeader(&stream, &header);
+  std::string encoded(deflateBound(&stream, text.size()) + 64, '\0');
+  stream.next_in = (Bytef *)text.data();
+  stream.avail_in = text.size();
+  stream.next_out = (Bytef *)&encoded[0];
+  stream.avail_out = encoded.size();
+  deflate(&stream, Z_FINISH);
+  encoded.resize(stream.total_out);
+  deflateEnd(&stream);
+  return encoded;
+}
+
+// Split text into chunks of chunkSize with the HTTP chunked framing, including an extension and a trailer
+static std::string chunked(const std::string &text, size_t chunkSize) {
+  std::string framed;
+  char size[16];
+  for (size_t start = 0; start < text.size(); start += chunkSize) {
+    std::string chunk = text.substr(start, chunkSize);
+    snprintf(size, sizeof(size), "%zx", chunk.size());
+    framed += std::string(size) + ((start == 0) ? ";name=value" : "") + "\r\n" + chunk + "\r\n";
+  }
+  return framed + "0\r\nX-Trailer: done\r\n\r\n";
+}
+
+// FNV-1a hash of the whole text, to check the hash the fetch works out slice by slice
+static uint32_t hashOf(const std::string &text) {
+  return fnv1aHash(CYD_WWX_FNV1A_OFFSET_BASIS, (const uint8_t *)text.data(), text.size());
+}
+
+static std::string withLength(const char *headers, const std::string &content) {
+  return std::string("HTTP/1.1 200 OK\r\n") + headers + "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n" + content;
+}
+
+static void testFraming() {
+  std::string document = makeDocument();
+
+  std::string lengthResponse = withLength("ETag: \"abc\"\r\nLast-Modified: Tue, 26 Nov 2024 17:40:00 GMT\r\n", document);
+  cydWeeWXFixtureTransport lengthFixture(lengthResponse.c_str(), nullptr);
+  fetch.setTransport(&lengthFixture);
+  CHECK(runFetch());
+  CHECK(fetch.statusCode == 200);
+  CHECK(fetch.bodyLength == document.size());
+  CHECK_TEXT(body, document.c_str());
+  CHECK_TEXT(fetch.eTag, "\"abc\"");
+  CHECK_TEXT(fetch.lastModified, "Tue, 26 Nov 2024 17:40:00 GMT");
+  CHECK(fetch.bodyHash == hashOf(document));
+
+  std::string chunkedResponse = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + chunked(document, 700);
+  cydWeeWXFixtureTransport chunkedFixture(chunkedResponse.c_str(), nullptr);
+  fetch.setTransport(&chunkedFixture);
+  CHECK(runFetch());
+  CHECK_TEXT(body, document.c_str());
+  CHECK(fetch.bodyHash == hashOf(document));  // The chunk framing is not hashed
+
+  // HTTP/1.0 with no length, the body ends when the server closes the connection
+  cydWeeWXFixtureTransport closeFixture("HTTP/1.0 200 OK\r\nContent-Type: application/json\r\n\r\n", document.c_str());
+  fetch.setTransport(&closeFixture);
+  CHECK(runFetch());
+  CHECK_TEXT(body, document.c_str());
+
+  cydWeeWXFixtureTransport notModified("HTTP/1.1 304 Not Modified\r\nETag: \"abc\"\r\n\r\n", nullptr);
+  fetch.setTransport(&notModified);
+  CHECK(runFetch());
+  CHECK(fetch.statusCode == 304);
+  CHECK(fetch.bodyLength == 0);
+  CHECK(fetch.bodyHash == CYD_WWX_FNV1A_OFFSET_BASIS);
+
+  cydWeeWXFixtureTransport informational("HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok", nullptr);
+  fetch.setTransport(&informational);
+  CHECK(runFetch());
+  CHECK(fetch.statusCode == 200);
+  CHECK_TEXT(body, "ok");
+
+  std::string tooLarge = withLength("", std::string(sizeof(body), 'x'));
+  cydWeeWXFixtureTransport tooLargeFixture(tooLarge.c_str(), nullptr);
+  fetch.setTransport(&tooLargeFixture);
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "response too large");
+
+  cydWeeWXFixtureTransport badStatus("SMTP ready\r\n\r\n", nullptr);
+  fetch.setTransport(&badStatus);
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "bad status line");
+
+  cydWeeWXFixtureTransport unknownEncoding("HTTP/1.1 200 OK\r\nContent-Encoding: br\r\nContent-Length: 2\r\n\r\nok", nullptr);
+  fetch.setTransport(&unknownEncoding);
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "unsupported content encoding");
+
+  // A validator too long to keep is dropped, not cut short
+  std::string longETag = withLength(("ETag: \"" + std::string(CYD_WWX_FETCH_VALIDATOR_LENGTH, 'e') + "\"\r\n").c_str(), "ok");
+  cydWeeWXFixtureTransport longETagFixture(longETag.c_str(), nullptr);
+  fetch.setTransport(&longETagFixture);
+  CHECK(runFetch());
+  CHECK_TEXT(fetch.eTag, "");
+
+  CHECK(!fetch.begin("ftp://weewx.local/", "", false));
+  CHECK_TEXT(fetch.errorMessage, "invalid URL");
+  CHECK(!fetch.begin("http:///cydweewx.json", "", false));
+  CHECK_TEXT(fetch.errorMessage, "invalid URL");
+  std::string longHost = "http://" + std::string(CYD_WWX_FETCH_HOST_LENGTH, 'h') + "/cydweewx.json";
+  CHECK(!fetch.begin(longHost.c_str(), "", false));
+  CHECK_TEXT(fetch.errorMessage, "invalid URL");
+  std::string longPath = "http://weewx.local/" + std::string(CYD_WWX_FETCH_REQUEST_LENGTH, 'p');
+  CHECK(!fetch.begin(longPath.c_str(), "", false));
+  CHECK_TEXT(fetch.errorMessage, "request too long");
+  fetch.setTransport(nullptr);
+}
+
+// gzip data holds zero bytes, so it is replayed by the script transport rather than the fixture transport
+static void testGzip() {
+  std::string document = makeDocument();
+  tinfl_decompressor inflater;
+  cydWeeWXScriptTransport server;
+  cydWeeWXFaultTransport trickle(&server);
+  fetch.setGzip(&inflater);
+  fetch.setTransport(&server);
+
+  std::string plain = gzip(document);
+  server.responses.push_back({withLength("Content-Encoding: gzip\r\n", plain), true});
+  CHECK(runFetch());
+  CHECK(server.lastRequest.find("Accept-Encoding: gzip\r\n") != std::string::npos);
+  CHECK(fetch.gzipped);
+  CHECK(fetch.encodedLength == plain.size());
+  CHECK(fetch.encodedLength < document.size());
+  CHECK_TEXT(body, document.c_str());
+  CHECK(fetch.bodyHash == hashOf(document));  // Hashed as inflated, the same as the plain body
+
+  // Every optional header field, trickled in small chunks so the header and deflate data are split up
+  std::string fields = gzip(document, "cydweewx.json", "xx", "comment", true);
+  server.responses.push_back({"HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n\r\n" + chunked(fields, 13), true});
+  trickle.readLimit = 5;
+  fetch.setTransport(&trickle);
+  CHECK(runFetch());
+  CHECK_TEXT(body, document.c_str());
+  CHECK(fetch.bodyHash == hashOf(document));
+  fetch.setTransport(&server);
+
+  // A server may ignore Accept-Encoding
+  server.responses.push_back({withLength("", document), true});
+  CHECK(runFetch());
+  CHECK(!fetch.gzipped);
+  CHECK_TEXT(body, document.c_str());
+
+  server.responses.push_back({withLength("Content-Encoding: gzip\r\n", plain.substr(0, plain.size() / 2)), true});
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "gzip data truncated");
+
+  // The body buffer is the limit on the inflated size
+  server.responses.push_back({withLength("Content-Encoding: gzip\r\n", gzip(std::string(sizeof(body) - 1, 'y'))), true});
+  CHECK(runFetch());
+  CHECK(fetch.bodyLength == sizeof(body) - 1);
+
+  server.responses.push_back({withLength("Content-Encoding: gzip\r\n", gzip(std::string(sizeof(body), 'y'))), true});
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "inflated response larger than the body buffer");
+  CHECK(fetch.bodyLength == sizeof(body) - 1);
+  CHECK(body[sizeof(body) - 1] == '\0');
+
+  server.responses.push_back({withLength("Content-Encoding: gzip\r\n", gzip(std::string(sizeof(body) * 4, ' '))), true});
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "inflated response larger than the body buffer");
+
+  server.responses.push_back({withLength("Content-Encoding: gzip\r\n", document), true});
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "bad gzip header");
+
+  fetch.setGzip(nullptr);
+  fetch.setTransport(nullptr);
+}
+
+static void testFaults() {
+  std::string document = makeDocument();
+  cydWeeWXFixtureTransport fixture("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n", document.c_str());
+  cydWeeWXFaultTransport faults(&fixture);
+  fetch.setTransport(&faults);
+
+  faults.readLimit = 1;
+  CHECK(runFetch());
+  CHECK_TEXT(body, document.c_str());
+  CHECK(fetch.stepCount > document.size());
+
+  faults.readLimit = 0;
+  faults.latency = 20;
+  CHECK(runFetch());
+  CHECK(fetch.connectTime >= 19);  // The latency is counted in whole msec
+  CHECK_TEXT(body, document.c_str());
+  faults.latency = 0;
+
+  // Cut short in the headers, and in a body that ends at the close so the short body is taken as the whole body
+  faults.truncateAfter = 20;
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "connection closed");
+  faults.truncateAfter = 100;
+  CHECK(runFetch());
+  CHECK(fetch.bodyLength == 100 - strlen("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n"));
+  faults.truncateAfter = SIZE_MAX;
+
+  faults.errorAfter = 100;
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "read failed");
+  CHECK(fetch.failedState == cydwwxfetchstate::READING_BODY);  // The server was reached
+  faults.errorAfter = SIZE_MAX;
+
+  faults.statusCode = 503;
+  CHECK(runFetch());
+  CHECK(fetch.statusCode == 503);
+  CHECK(fetch.bodyLength == 0);
+  faults.statusCode = 0;
+
+  faults.refuseConnect = true;
+  CHECK(!runFetch());
+  CHECK_TEXT(fetch.errorMessage, "connect failed");
+  CHECK(fetch.failedState == cydwwxfetchstate::CONNECTING);
+  faults.refuseConnect = false;
+
+  // Timeouts are reached by moving the host clock forward
+  faults.latency = 60000;
+  CHECK(fetch.begin("http://weewx.local/cydweewx.json", "", false));
+  fetch.step();
+  cydWeeWXHostClockOffset += (CYD_WWX_HTTP_CONNECT_TIMEOUT + 1) * 1000LL;
+  while (fetch.step()) {
+  }
+  CHECK_TEXT(fetch.errorMessage, "connect timed out");
+  CHECK(fetch.failedState == cydwwxfetchstate::CONNECTING);
+  faults.latency = 0;
+
+  cydWeeWXSilentTransport silent;
+  fetch.setTransport(&silent);
+  CHECK(fetch.begin("http://weewx.local/cydweewx.json", "", false));
+  fetch.step();
+  fetch.step();
+  cydWeeWXHostClockOffset += (CYD_WWX_HTTP_READ_TIMEOUT + 1) * 1000LL;
+  while (fetch.step()) {
+  }
+  CHECK_TEXT(fetch.errorMessage, "read timed out");
+  fetch.setTransport(nullptr);
+}
+
+static void testKeepAlive() {
+  std::string document = makeDocument();
+  cydWeeWXScriptTransport server;
+  server.responses.push_back({withLength("Connection: keep-alive\r\n", document), false});
+  server.responses.push_back({withLength("", "second"), false});
+  server.responses.push_back({withLength("", "third"), false});
+  server.responses.push_back({withLength("Connection: close\r\n", "fourth"), false});
+  server.responses.push_back({withLength("", "fifth"), false});
+  server.responses.push_back({"HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nsix", true});
+  fetch.setTransport(&server);
+
+  CHECK(runFetch("http://weewx.local:8080/cydweewx.json", true));
+  CHECK(!fetch.connectionReused);
+  CHECK(server.openCount == 1);
+  CHECK(server.lastRequest.find("Host: weewx.local:8080\r\n") != std::string::npos);
+  CHECK(server.lastRequest.find("Connection: keep-alive\r\n") != std::string::npos);
+  CHECK_TEXT(body, document.c_str());
+
+  CHECK(runFetch("http://weewx.local:8080/cydweewx.json", true));
+  CHECK(fetch.connectionReused);
+  CHECK(server.openCount == 1);
+  CHECK_TEXT(body, "second");
+
+  // The server dropped the idle connection, so the request is sent again on a new one
+  server.closeIdleConnection();
+  CHECK(runFetch("http://weewx.local:8080/cydweewx.json", true));
+  CHECK(!fetch.connectionReused);
+  CHECK(server.openCount == 2);
+  CHECK_TEXT(body, "third");
+
+  // Connection: close from the server means the next fetch needs a new connection
+  CHECK(runFetch("http://weewx.local:8080/cydweewx.json", true));
+  CHECK_TEXT(body, "fourth");
+  CHECK(runFetch("http://weewx.local:8080/cydweewx.json", true));
+  CHECK(!fetch.connectionReused);
+  CHECK(server.openCount == 3);
+  CHECK_TEXT(body, "fifth");
+
+  // Closed part way through a response on a kept connection is not retried
+  CHECK(!runFetch("http://weewx.local:8080/cydweewx.json", true));
+  CHECK(fetch.connectionReused);
+  CHECK_TEXT(fetch.errorMessage, "connection closed");
+  CHECK(server.openCount == 3);
+  fetch.setTransport(nullptr);
+}
+
+static void testResolver() {
+  cydWeeWXResolver resolver;
+  cydWeeWXFixtureTransport fixture("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n", "ok");
+  fetch.setResolver(&resolver);
+  fetch.setTransport(&fixture);
+
+  WiFi.lookupCount = 0;
+  CHECK(runFetch());
+  CHECK(WiFi.lookupCount == 0);  // The fixture does not use the address
+
+  class cydWeeWXAddressTransport : public cydWeeWXFixtureTransport {
+    public:
+      using cydWeeWXFixtureTransport::cydWeeWXFixtureTransport;
+      std::string host;
+      bool open(const char *host, uint16_t port, bool secure) override {
+        this->host = host;
+        return cydWeeWXFixtureTransport::open(host, port, secure);
+      }
+      bool needsAddress() override { return true; }
+  } network("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n", "ok");
+  fetch.setTransport(&network);
+  CHECK(runFetch());
+  CHECK(network.host == "192.168.1.10");
+  CHECK(runFetch());
+  CHECK(WiFi.lookupCount == 1);
+  CHECK(resolver.cacheHits == 1);
+
+  // A failed lookup falls back to the last address that was found
+  WiFi.lookupFails = true;
+  resolver.expire("weewx.local");
+  CHECK(runFetch());
+  CHECK(network.host == "192.168.1.10");
+  CHECK(resolver.fallbacks == 1);
+
+  CHECK(!runFetch("http://other.local/cydweewx.json"));
+  CHECK_TEXT(fetch.errorMessage, "name lookup failed");
+  CHECK(fetch.failedState == cydwwxfetchstate::CONNECTING);
+  WiFi.lookupFails = false;
+  fetch.setResolver(nullptr);
+  fetch.setTransport(nullptr);
+}
+
+// Polls of the WeeWX file the way getWeeWXData() makes them, with the conditional GET headers, the
+// resolver and kept connections the server has closed, must not touch the heap once the resolver
+// has the address. gzip is left out as the host inflater stands in for the ROM one with zlib.
+static void testNoHeap() {
+  class cydWeeWXAddressTransport : public cydWeeWXFixtureTransport {
+    public:
+      using cydWeeWXFixtureTransport::cydWeeWXFixtureTransport;
+      bool needsAddress() override { return true; }
+  };
+  std::string document = makeDocument();
+  std::string response = withLength("ETag: \"abc\"\r\nLast-Modified: Tue, 26 Nov 2024 17:40:00 GMT\r\n", document);
+  cydWeeWXAddressTransport network(response.c_str(), nullptr);
+  cydWeeWXResolver resolver;
+  fetch.setTransport(&network);
+  fetch.setResolver(&resolver);
+  const char *url = "http://weewx.local:8080/cyd_weewx.json";
+  const char *headers = "If-None-Match: \"abc\"\r\nIf-Modified-Since: Tue, 26 Nov 2024 17:40:00 GMT\r\n";
+  CHECK(runFetch(url));
+
+  size_t heapCallsBefore = cydWeeWXHeapCalls;
+  int goodPolls = 0;
+  for (int poll = 0; poll < CYD_WWX_TEST_POLLS; poll++) {
+    if (fetch.begin(url, headers, (poll % 2) == 0)) {
+      while (fetch.step()) {
+      }
+      goodPolls += (!fetch.failed() && (fetch.bodyLength == document.size()) && (strcmp(fetch.eTag, "\"abc\"") == 0)) ? 1 : 0;
+    }
+  }
+  size_t heapCalls = cydWeeWXHeapCalls - heapCallsBefore;
+  CHECK(goodPolls == CYD_WWX_TEST_POLLS);
+  CHECK(heapCalls == 0);
+  printf("%d WeeWX polls: %zu heap calls, %u address lookups.\n", CYD_WWX_TEST_POLLS, heapCalls, resolver.lookups);
+  fetch.setResolver(nullptr);
+  fetch.setTransport(nullptr);
+}
+
+int main() {
+  testFraming();
+  testGzip();
+  testFaults();
+  testKeepAlive();
+  testResolver();
+  testNoHeap();
+  return cydWeeWXTestResult();
+}
@@ -0,0 +1,173 @@
+// **********************************************************************************
+// ** Host test and benchmark for formatFixed
+// ** Every value is formatted with formatFixed and with snprintf("%*.*f") and the
+// ** two must give the same bytes and the same length: hand picked values for ties
+// ** to even, negative zero, width padding and short buffers, then values made up
+// ** of random bits, exact ties and subnormals at every width and precision the
+// ** display uses. The time of each is printed for the readings of a WeeWX poll.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXFormat.h"
+#include "cydWeeWXTest.h"
+
+#include <chrono>
+#include <random>
+
+#define CYD_WWX_TEST_RANDOM_VALUES 200000
+#define CYD_WWX_TEST_FORMATS 1000000
+
+static uint32_t mismatches = 0;
+
+// Compare formatFixed with snprintf for one value, width, precision and buffer size
+static bool sameAsPrintf(double value, int width, int decimals, size_t size = 32) {
+  char expected[64];
+  char actual[64];
+  memset(actual, '#', sizeof(actual));
+  int expectedLength = snprintf(expected, size, "%*.*f", width, decimals, value);
+  int actualLength = formatFixed(actual, size, value, width, decimals);
+  bool same = (actualLength == expectedLength) && ((size == 0) || (strcmp(actual, expected) == 0));
+  if (!same && (++mismatches <= 10)) {
+    printf("  %.17g width %d decimals %d size %zu: \"%s\" (%d), printf \"%s\" (%d)\n", value, width, decimals, size,
+           (size == 0) ? "" : actual, actualLength, (size == 0) ? "" : expected, expectedLength);
+  }
+  return same;
+}
+
+static void testCases() {
+  // Ties go to the even digit, as the binary value is exactly half way
+  CHECK(sameAsPrintf(0.5, 0, 0));
+  CHECK(sameAsPrintf(1.5, 0, 0));
+  CHECK(sameAsPrintf(2.5, 0, 0));
+  CHECK(sameAsPrintf(-2.5, 0, 0));
+  CHECK(sameAsPrintf(0.125, 0, 2));
+  CHECK(sameAsPrintf(0.375, 0, 2));
+  CHECK(sameAsPrintf(1.0625, 0, 3));
+  char text[16];
+  formatFixed(text, sizeof(text), 2.5, 0, 0);
+  CHECK_TEXT(text, "2");
+  formatFixed(text, sizeof(text), 0.125, 0, 2);
+  CHECK_TEXT(text, "0.12");
+
+  // Values that only look like ties are rounded by their binary value
+  CHECK(sameAsPrintf(0.15, 0, 1));
+  CHECK(sameAsPrintf(0.25, 0, 1));
+  CHECK(sameAsPrintf(0.35, 0, 1));
+  CHECK(sameAsPrintf(1005.8235273191686, 6, 1));
+  CHECK(sameAsPrintf(999.95, 6, 1));
+  CHECK(sameAsPrintf(9.9999, 0, 3));
+
+  // Negative zero and negative values that round to zero keep the sign
+  CHECK(sameAsPrintf(-0.0, 6, 1));
+  CHECK(sameAsPrintf(-0.04, 6, 1));
+  CHECK(sameAsPrintf(-0.4, 2, 0));
+  formatFixed(text, sizeof(text), -0.0, 6, 1);
+  CHECK_TEXT(text, "  -0.0");
+
+  // Width pads on the left and never cuts the text
+  CHECK(sameAsPrintf(1.5, 6, 1));
+  CHECK(sameAsPrintf(-1.5, 6, 1));
+  CHECK(sameAsPrintf(12345.678, 4, 1));
+  CHECK(sameAsPrintf(51.479, 0, 3));
+  CHECK(sameAsPrintf(-0.0, 0, 3));
+  CHECK(sameAsPrintf(265.35, 4, 0));
+  CHECK(sameAsPrintf(95.0, 2, 0));
+  CHECK(sameAsPrintf(1.0, 24, 3));
+
+  // Short buffers are cut and the full length returned
+  CHECK(sameAsPrintf(1005.8235, 6, 1, 4));
+  CHECK(sameAsPrintf(1005.8235, 6, 1, 1));
+  CHECK(sameAsPrintf(1005.8235, 6, 1, 0));
+  CHECK(sameAsPrintf(-12.5, 8, 2, 7));
+
+  // Left to printf
+  CHECK(sameAsPrintf(NAN, 6, 1));
+  CHECK(sameAsPrintf(-INFINITY, 6, 1));
+  CHECK(sameAsPrintf(1e15, 0, 1));
+  CHECK(sameAsPrintf(-3e20, 0, 0));
+  CHECK(sameAsPrintf(1.25, 0, 4));
+  CHECK(sameAsPrintf(1.25, 30, 1));
+
+  // Largest values done without printf
+  CHECK(sameAsPrintf(999999999999999.9, 0, 0));
+  CHECK(sameAsPrintf(-999999999999999.9, 0, 3));
+  CHECK(sameAsPrintf(4503599627370495.5 / 8, 0, 3));
+}
+
+static void testRandom() {
+  std::mt19937_64 random(20241126);
+  uint32_t before = mismatches;
+  for (int index = 0; index < CYD_WWX_TEST_RANDOM_VALUES; index++) {
+    double value;
+    uint64_t bits = random();
+    switch (index % 5) {
+      case 0:  // Any bits
+        memcpy(&value, &bits, sizeof(value));
+        break;
+      case 1:  // Station readings
+        value = std::uniform_real_distribution<double>(-100.0, 1100.0)(random);
+        break;
+      case 2:  // Exact ties and near ties at 0 to 3 decimal places
+        value = (double)(int64_t)(bits % 2000001 - 1000000) / 2000.0;
+        break;
+      case 3:  // Subnormals
+        bits &= 0x800FFFFFFFFFFFFFULL;
+        memcpy(&value, &bits, sizeof(value));
+        break;
+      default:  // Every magnitude up to 10^15
+        value = ldexp((double)(bits >> 11) / 9007199254740992.0, (int)(bits % 100) - 50);
+        if (bits & 1) {
+          value = -value;
+        }
+        break;
+    }
+    for (int decimals = 0; decimals <= 3; decimals++) {
+      sameAsPrintf(value, (index + decimals) % 9, decimals);
+    }
+  }
+  CHECK(mismatches == before);
+}
+
+// The readings of one WeeWX poll, formatted as updateWeeWXReadings() does
+static const struct {
+  double value;
+  int width;
+  int decimals;
+} readings[] = {
+  {1.546666666666666, 6, 1}, {0.43333333333333, 6, 1}, {95.0, 2, 0}, {1.0, 2, 0},
+  {20.299999999999986, 6, 1}, {1.0, 6, 1}, {-1.0, 6, 1}, {3.1, 6, 1}, {-2.0, 6, 1},
+  {265.35, 4, 0}, {1005.8235273191686, 6, 1}, {0.20536802181527491, 6, 1},
+  {0.0, 6, 1}, {-0.9599999990207999, 6, 1}, {51.479, 0, 3}, {-0.0, 0, 3},
+};
+
+#define CYD_WWX_TEST_READINGS (sizeof(readings) / sizeof(readings[0]))
+
+static void benchmark() {
+  char text[16];
+  uint32_t total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < CYD_WWX_TEST_FORMATS; index++) {
+    const auto &reading = readings[index % CYD_WWX_TEST_READINGS];
+    total += formatFixed(text, sizeof(text), reading.value, reading.width, reading.decimals);
+  }
+  double fixedTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_FORMATS;
+
+  start = std::chrono::steady_clock::now();
+  for (int index = 0; index < CYD_WWX_TEST_FORMATS; index++) {
+    const auto &reading = readings[index % CYD_WWX_TEST_READINGS];
+    total -= snprintf(text, sizeof(text), "%*.*f", reading.width, reading.decimals, reading.value);
+  }
+  double printfTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_FORMATS;
+
+  CHECK(total == 0);
+  printf("Reading formatted with formatFixed: %.0f ns, with snprintf: %.0f ns.\n", fixedTime, printfTime);
+}
+
+int main() {
+  testCases();
+  testRandom();
+  benchmark();
+  return cydWeeWXTestResult();
+}
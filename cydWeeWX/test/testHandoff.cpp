@@ -0,0 +1,105 @@
+// **********************************************************************************
+// ** Host stress test for cydWeeWXHandoff
+// ** A producer thread publishes numbered values as fast as it can while a consumer
+// ** thread picks them up and checks that no value is torn (a mix of two publishes),
+// ** changes while it is being read, goes backwards, or is missed at the end. Both
+// ** threads yield part way through now and then so the interleavings also happen on
+// ** a single core.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXHandoff.h"
+#include "cydWeeWXTest.h"
+
+#include <atomic>
+#include <thread>
+
+#define CYD_WWX_TEST_PUBLISHES 200000
+#define CYD_WWX_TEST_WORDS 256                // About the size of the weather snapshot
+
+// Every word holds a value worked out from the sequence number, so a torn value does not check out
+struct cydWeeWXTestValue {
+  uint64_t sequence = 0;
+  uint64_t words[CYD_WWX_TEST_WORDS] = {};
+};
+
+static uint64_t wordFor(uint64_t sequence, int index) {
+  return sequence * 0x9E3779B97F4A7C15ULL + index;
+}
+
+static bool isWhole(const cydWeeWXTestValue &value) {
+  for (int index = 0; index < CYD_WWX_TEST_WORDS; index++) {
+    if (value.words[index] != wordFor(value.sequence, index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static cydWeeWXHandoff<cydWeeWXTestValue> handoff;
+
+int main() {
+  std::atomic<bool> producerDone{false};
+  uint64_t torn = 0;
+  uint64_t changed = 0;
+  uint64_t backwards = 0;
+  uint64_t updates = 0;
+  uint64_t lastSequence = 0;
+
+  std::thread producer([&]() {
+    for (uint64_t sequence = 1; sequence <= CYD_WWX_TEST_PUBLISHES; sequence++) {
+      cydWeeWXTestValue &value = handoff.writeBuffer();
+      value.sequence = sequence;
+      for (int index = 0; index < CYD_WWX_TEST_WORDS; index++) {
+        value.words[index] = wordFor(sequence, index);
+        if ((index == CYD_WWX_TEST_WORDS / 2) && ((sequence % 8) == 0)) {
+          std::this_thread::yield();  // Let the consumer run while this buffer is half written
+        }
+      }
+      handoff.publish();
+    }
+    producerDone.store(true, std::memory_order_release);
+  });
+
+  std::thread consumer([&]() {
+    bool finished = false;
+    while (!finished) {
+      finished = producerDone.load(std::memory_order_acquire);  // One more update after the last publish
+      if (!handoff.update()) {
+        std::this_thread::yield();
+        continue;
+      }
+      updates += 1;
+      const cydWeeWXTestValue &value = handoff.read();
+      uint64_t sequence = value.sequence;
+      if (!isWhole(value)) {
+        torn += 1;
+      }
+      if (sequence <= lastSequence) {
+        backwards += 1;
+      }
+      lastSequence = sequence;
+      if ((updates % 2) == 0) {  // The value must not change while the producer carries on
+        std::this_thread::yield();
+        if ((value.sequence != sequence) || !isWhole(value)) {
+          changed += 1;
+        }
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  printf("%d publishes, %llu picked up\n", CYD_WWX_TEST_PUBLISHES, (unsigned long long)updates);
+  CHECK(torn == 0);
+  CHECK(changed == 0);
+  CHECK(backwards == 0);
+  CHECK(updates > 1);
+  CHECK(lastSequence == CYD_WWX_TEST_PUBLISHES);  // The last value published is not lost
+  CHECK(!handoff.update());                        // and nothing is picked up twice
+  CHECK(handoff.read().sequence == CYD_WWX_TEST_PUBLISHES);
+  return cydWeeWXTestResult();
+}
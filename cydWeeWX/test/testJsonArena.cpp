@@ -0,0 +1,194 @@
+// **********************************************************************************
+// ** Host test and benchmark for the cydWeeWX JSON arena
+// ** The allocators are driven the way ArduinoJson drives them while it parses a
+// ** document, and every malloc, realloc and free in the process is counted to show
+// ** the general heap is not touched while the arena has room. Blocks that do not fit
+// ** must spill over to the heap and be given back, and reset() must take back the
+// ** space of a block that was never freed. The same parse is timed with the arena
+// ** and with the heap.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+#include "cydWeeWXHeapCount.h"
+#include "cydWeeWXJsonArena.h"
+#include "cydWeeWXTest.h"
+
+#include <chrono>
+
+#define CYD_WWX_TEST_PARSES 100000
+#define CYD_WWX_TEST_POOL_SIZE 2048           // Slot pool ArduinoJson allocates for a document
+#define CYD_WWX_TEST_STRINGS 40               // Keys and string values kept in the document
+#define CYD_WWX_TEST_STRING_BUFFER 31         // First size of the buffer a string is read into
+
+// The calls ArduinoJson 7 makes for one document: a slot pool, then for each string a buffer that
+// doubles while the text is read and is shrunk to the text when it is kept, then the pool shrunk
+// to the slots used. The document is destroyed at the end. Returns false if any string was
+// overwritten by a later block.
+static bool parseLike(ArduinoJson::Allocator &allocator) {
+  uint8_t *pool = (uint8_t *)allocator.allocate(CYD_WWX_TEST_POOL_SIZE);
+  if (pool == nullptr) {
+    return false;
+  }
+  memset(pool, 0xA5, CYD_WWX_TEST_POOL_SIZE);
+  char *strings[CYD_WWX_TEST_STRINGS];
+  size_t lengths[CYD_WWX_TEST_STRINGS];
+  for (int index = 0; index < CYD_WWX_TEST_STRINGS; index++) {
+    size_t capacity = CYD_WWX_TEST_STRING_BUFFER;
+    char *buffer = (char *)allocator.allocate(capacity);
+    lengths[index] = 4 + (index * 7) % 60;
+    while (lengths[index] > capacity) {
+      capacity *= 2;
+      buffer = (char *)allocator.reallocate(buffer, capacity);
+    }
+    memset(buffer, 'a' + index % 26, lengths[index]);
+    strings[index] = (char *)allocator.reallocate(buffer, lengths[index]);
+  }
+  pool = (uint8_t *)allocator.reallocate(pool, CYD_WWX_TEST_POOL_SIZE / 2);
+
+  bool intact = (pool[0] == 0xA5) && (pool[CYD_WWX_TEST_POOL_SIZE / 2 - 1] == 0xA5);
+  for (int index = 0; index < CYD_WWX_TEST_STRINGS; index++) {
+    for (size_t position = 0; position < lengths[index]; position++) {
+      intact = intact && (strings[index][position] == 'a' + index % 26);
+    }
+    allocator.deallocate(strings[index]);
+  }
+  allocator.deallocate(pool);
+  return intact;
+}
+
+static cydWeeWXArenaAllocator arena;
+
+static void testNoHeap() {
+  arena.reset();
+  size_t before = cydWeeWXHeapCalls;
+  bool intact = true;
+  for (int parse = 0; parse < 1000; parse++) {
+    intact = parseLike(arena) && intact;
+    arena.reset();
+  }
+  CHECK(cydWeeWXHeapCalls == before);
+  CHECK(intact);
+  CHECK(arena.overflowCount == 0);
+  CHECK(arena.currentSize == 0);
+}
+
+static void testInPlace() {
+  arena.reset();
+  uint8_t *first = (uint8_t *)arena.allocate(100);
+  uint8_t *last = (uint8_t *)arena.allocate(100);
+  memset(last, 7, 100);
+
+  // The last block grows and shrinks where it is
+  CHECK(arena.reallocate(last, 1000) == last);
+  CHECK(arena.reallocate(last, 10) == last);
+  CHECK(arena.currentSize == 110);
+
+  // A block below the top is moved to grow, with its contents
+  memset(first, 9, 100);
+  uint8_t *moved = (uint8_t *)arena.reallocate(first, 200);
+  CHECK(moved != first);
+  CHECK((moved[0] == 9) && (moved[99] == 9));
+  CHECK(arena.currentSize == 210);
+  CHECK(arena.peakSize == 1100);
+
+  // The space is given back once every block is freed
+  arena.deallocate(last);
+  arena.deallocate(moved);
+  CHECK(arena.currentSize == 0);
+  size_t before = cydWeeWXHeapCalls;
+  void *whole = arena.allocate(CYD_WWX_JSON_ARENA_SIZE - CYD_WWX_ARENA_HEADER);
+  CHECK(cydWeeWXHeapCalls == before);
+  arena.deallocate(whole);
+  CHECK(arena.overflowCount == 0);
+}
+
+static void testOverflow() {
+  arena.reset();
+  size_t before = cydWeeWXHeapCalls;
+  uint8_t *block = (uint8_t *)arena.allocate(CYD_WWX_JSON_ARENA_SIZE);
+  CHECK(block != nullptr);
+  CHECK(arena.overflowCount == 1);
+  CHECK(cydWeeWXHeapCalls == before + 1);
+  memset(block, 1, CYD_WWX_JSON_ARENA_SIZE);
+
+  // A heap block grows on the heap and is freed there
+  block = (uint8_t *)arena.reallocate(block, 2 * CYD_WWX_JSON_ARENA_SIZE);
+  CHECK((block[0] == 1) && (block[CYD_WWX_JSON_ARENA_SIZE - 1] == 1));
+  CHECK(arena.currentSize == 2 * CYD_WWX_JSON_ARENA_SIZE);
+  arena.deallocate(block);
+  CHECK(cydWeeWXHeapCalls == before + 3);
+  CHECK(arena.currentSize == 0);
+
+  // An arena block that outgrows the arena moves to the heap
+  uint8_t *small = (uint8_t *)arena.allocate(64);
+  void *next = arena.allocate(64);  // Keeps the first block from growing in place
+  memset(small, 2, 64);
+  uint8_t *large = (uint8_t *)arena.reallocate(small, CYD_WWX_JSON_ARENA_SIZE);
+  CHECK(arena.overflowCount == 2);
+  CHECK((large[0] == 2) && (large[63] == 2));
+  arena.deallocate(large);
+  arena.deallocate(next);
+  CHECK(arena.currentSize == 0);
+  arena.overflowCount = 0;
+}
+
+static void testResetRecovers() {
+  arena.reset();
+  arena.allocate(CYD_WWX_JSON_ARENA_SIZE / 2);  // Never freed
+  arena.reset();                                // Logs the block and takes its space back
+  CHECK(arena.currentSize == 0);
+  size_t before = cydWeeWXHeapCalls;
+  void *whole = arena.allocate(CYD_WWX_JSON_ARENA_SIZE - CYD_WWX_ARENA_HEADER);
+  CHECK(cydWeeWXHeapCalls == before);
+  CHECK(arena.overflowCount == 0);
+  arena.deallocate(whole);
+}
+
+static void testCountingAllocator() {
+  cydWeeWXCountingAllocator counting;
+  void *first = counting.allocate(100);
+  void *second = counting.allocate(50);
+  second = counting.reallocate(second, 500);
+  CHECK(counting.currentSize == 600);
+  counting.deallocate(first);
+  CHECK(counting.currentSize == 500);
+  CHECK(counting.peakSize == 600);
+  counting.deallocate(second);
+  CHECK(counting.currentSize == 0);
+  CHECK(parseLike(counting));
+  CHECK(counting.currentSize == 0);
+}
+
+static void benchmark() {
+  auto start = std::chrono::steady_clock::now();
+  for (int parse = 0; parse < CYD_WWX_TEST_PARSES; parse++) {
+    parseLike(arena);
+    arena.reset();
+  }
+  double arenaTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_PARSES;
+
+  cydWeeWXCountingAllocator counting;
+  size_t before = cydWeeWXHeapCalls;
+  start = std::chrono::steady_clock::now();
+  for (int parse = 0; parse < CYD_WWX_TEST_PARSES; parse++) {
+    parseLike(counting);
+  }
+  double heapTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_PARSES;
+  double calls = (double)(cydWeeWXHeapCalls - before) / CYD_WWX_TEST_PARSES;
+
+  printf("Document allocations, arena of %d bytes: %.0f ns and no heap calls. Heap: %.0f ns and %.0f heap calls.\n",
+         CYD_WWX_JSON_ARENA_SIZE, arenaTime, heapTime, calls);
+}
+
+int main() {
+  testNoHeap();
+  testInPlace();
+  testOverflow();
+  testResetRecovers();
+  testCountingAllocator();
+  benchmark();
+  return cydWeeWXTestResult();
+}
@@ -0,0 +1,172 @@
+// **********************************************************************************
+// ** Host test and benchmark for cydWeeWXSnapshot
+// ** Every heap allocation is counted while snapshots are filled in and passed through
+// ** the handoff the way the network task and display do, and there must be none. The
+// ** same update is timed against a snapshot holding std::string fields, as it did
+// ** with Arduino Strings, to show what the fixed size fields save.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXDefines.h"
+#include "cydWeeWXFormat.h"
+#include "cydWeeWXHandoff.h"
+#include "cydWeeWXSnapshot.h"
+#include "cydWeeWXTest.h"
+
+#include <chrono>
+#include <new>
+#include <string>
+
+#define CYD_WWX_TEST_UPDATES 100000
+
+static size_t heapAllocations = 0;
+
+void *operator new(size_t size) {
+  heapAllocations += 1;
+  void *block = malloc(size);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  return block;
+}
+
+void operator delete(void *block) noexcept {
+  free(block);
+}
+
+void operator delete(void *block, size_t size) noexcept {
+  free(block);
+}
+
+static const char *const units[] = {"°C", "%", "km/h", "km/h", "mbar", "mm/h"};
+static const char *const trends[] = {"", "", ""};
+
+// The fields a WeeWX poll changes, filled in as updateWeeWXReadings() does
+static void fillSnapshot(cydWeeWXSnapshot &snapshot, int poll) {
+  char text[CYD_WWX_HEADER_TEXT_LENGTH];
+  snprintf(text, sizeof(text), "Ottawa, Ontario - 26 Nov 2024 %02d:%02d", (poll / 60) % 24, poll % 60);
+  setSnapshotText(snapshot.screenHeader, text);
+  setSnapshotText(snapshot.location, "Ottawa, Ontario");
+  for (int sensor = 0; sensor < (int)cydwwxsensor::MAX_SENSORS; sensor++) {
+    cydWeeWXReadingText &reading = snapshot.readings[sensor];
+    formatFixed(reading.value, sizeof(reading.value), (poll % 400) * 0.1 + sensor, 5, 1);
+    setSnapshotText(reading.units, units[sensor]);
+    setSnapshotText(reading.trend, trends[(poll + sensor) % 3]);
+  }
+  formatFixed(snapshot.insideTemperature, sizeof(snapshot.insideTemperature), 21.5 + (poll % 10) * 0.1, 5, 1);
+  setSnapshotText(snapshot.sunrise, "07:12");
+  setSnapshotText(snapshot.sunset, "16:23");
+  setSnapshotText(snapshot.moonPhase, "Waning crescent");
+  snapshot.weatherCode = poll % 100;
+}
+
+// Snapshot as it was with String fields, for the comparison
+struct cydWeeWXStringSnapshot {
+  std::string location;
+  std::string screenHeader;
+  std::string values[(int)cydwwxsensor::MAX_SENSORS];
+  std::string units[(int)cydwwxsensor::MAX_SENSORS];
+  std::string trends[(int)cydwwxsensor::MAX_SENSORS];
+  std::string insideTemperature;
+  std::string sunrise;
+  std::string sunset;
+  std::string moonPhase;
+  int weatherCode = 0;
+};
+
+static void fillStringSnapshot(cydWeeWXStringSnapshot &snapshot, int poll) {
+  char text[CYD_WWX_HEADER_TEXT_LENGTH];
+  snprintf(text, sizeof(text), "Ottawa, Ontario - 26 Nov 2024 %02d:%02d", (poll / 60) % 24, poll % 60);
+  snapshot.screenHeader = text;
+  snapshot.location = "Ottawa, Ontario";
+  for (int sensor = 0; sensor < (int)cydwwxsensor::MAX_SENSORS; sensor++) {
+    snprintf(text, sizeof(text), "%5.1f", (poll % 400) * 0.1 + sensor);
+    snapshot.values[sensor] = text;
+    snapshot.units[sensor] = units[sensor];
+    snapshot.trends[sensor] = trends[(poll + sensor) % 3];
+  }
+  snprintf(text, sizeof(text), "%5.1f", 21.5 + (poll % 10) * 0.1);
+  snapshot.insideTemperature = text;
+  snapshot.sunrise = "07:12";
+  snapshot.sunset = "16:23";
+  snapshot.moonPhase = "Waning crescent";
+  snapshot.weatherCode = poll % 100;
+}
+
+static cydWeeWXSnapshot networkSnapshot;
+static cydWeeWXHandoff<cydWeeWXSnapshot> weatherHandoff;
+static cydWeeWXStringSnapshot stringSnapshot;
+static cydWeeWXStringSnapshot stringCopy;
+
+static void testText() {
+  cydWeeWXSnapshot snapshot;
+  CHECK_TEXT(snapshot.sunrise, CYD_WWX_PLACEHOLDER_READING);
+  CHECK_TEXT(snapshot.screenHeader, CYD_WWX_PLACEHOLDER_HEADER);
+  CHECK(snapshot.weatherCode == CYD_WWX_LOADING_STATE_CODE);
+
+  CHECK(setSnapshotText(snapshot.moonPhase, "Full moon"));
+  CHECK(!setSnapshotText(snapshot.moonPhase, "Full moon"));
+  CHECK(setSnapshotText(snapshot.moonPhase, "Full"));
+  CHECK_TEXT(snapshot.moonPhase, "Full");
+  CHECK(setSnapshotText(snapshot.moonPhase, nullptr));
+  CHECK_TEXT(snapshot.moonPhase, "");
+  CHECK(!setSnapshotText(snapshot.moonPhase, ""));
+
+  // Cut short to the field, and the same long text again is not a change
+  const char *longName = "A station location name that is much too long to fit in the location field of the snapshot";
+  CHECK(setSnapshotText(snapshot.location, longName));
+  CHECK(strlen(snapshot.location) == sizeof(snapshot.location) - 1);
+  CHECK(strncmp(snapshot.location, longName, sizeof(snapshot.location) - 1) == 0);
+  CHECK(!setSnapshotText(snapshot.location, longName));
+}
+
+static void testNoHeap() {
+  size_t before = heapAllocations;
+  uint32_t pickedUp = 0;
+  for (int poll = 0; poll < CYD_WWX_TEST_UPDATES; poll++) {
+    fillSnapshot(networkSnapshot, poll);
+    weatherHandoff.writeBuffer() = networkSnapshot;
+    weatherHandoff.publish();
+    if (weatherHandoff.update()) {
+      pickedUp += 1;
+    }
+  }
+  CHECK(heapAllocations == before);
+  CHECK(pickedUp == CYD_WWX_TEST_UPDATES);
+  const cydWeeWXSnapshot &weather = weatherHandoff.read();
+  CHECK_TEXT(weather.location, "Ottawa, Ontario");
+  CHECK_TEXT(weather.reading(cydwwxsensor::TEMPERATURE).value, " 39.9");
+  CHECK_TEXT(weather.reading(cydwwxsensor::PRESSURE).units, "mbar");
+}
+
+static void benchmark() {
+  auto start = std::chrono::steady_clock::now();
+  for (int poll = 0; poll < CYD_WWX_TEST_UPDATES; poll++) {
+    fillSnapshot(networkSnapshot, poll);
+    weatherHandoff.writeBuffer() = networkSnapshot;
+    weatherHandoff.publish();
+    weatherHandoff.update();
+  }
+  double fixedTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_UPDATES;
+
+  size_t before = heapAllocations;
+  start = std::chrono::steady_clock::now();
+  for (int poll = 0; poll < CYD_WWX_TEST_UPDATES; poll++) {
+    fillStringSnapshot(stringSnapshot, poll);
+    stringCopy = stringSnapshot;
+  }
+  double stringTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_UPDATES;
+  double stringAllocations = (double)(heapAllocations - before) / CYD_WWX_TEST_UPDATES;
+
+  printf("Snapshot of %zu bytes, update and hand over: %.0f ns and no allocations. With string fields: %.0f ns and %.2f allocations.\n",
+         sizeof(cydWeeWXSnapshot), fixedTime, stringTime, stringAllocations);
+}
+
+int main() {
+  testText();
+  testNoHeap();
+  benchmark();
+  return cydWeeWXTestResult();
+}
@@ -0,0 +1,216 @@
+// **********************************************************************************
+// ** Host test and benchmark for the WeeWX time stamp parsing
+// ** Report times in the ISO format with each kind of UTC offset and in the human
+// ** format, the almanac and dimmer times of day, and text that must be refused.
+// ** Random times are written out with strftime, parsed back and checked against
+// ** gmtime. The parse is timed against sscanf and timegm.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXTime.h"
+#include "cydWeeWXTest.h"
+
+#include <chrono>
+#include <random>
+#include <stdlib.h>
+#include <time.h>
+
+#define CYD_WWX_TEST_ROUND_TRIPS 100000
+#define CYD_WWX_TEST_PARSES 1000000
+#define CYD_WWX_TEST_REPORT_EPOCH 1732624800  // 2024-11-26T12:40:00Z
+
+// Parse and check the epoch and UTC offset
+static bool parsesTo(const char *text, int64_t epoch, int32_t utcOffset, bool hasOffset) {
+  cydWeeWXTimestamp time;
+  bool parsed = parseWeeWXTimestamp(text, time);
+  bool same = parsed && (time.epoch == epoch) && (time.utcOffset == utcOffset) && (time.hasOffset == hasOffset);
+  if (!same) {
+    printf("  \"%s\": parsed %d, epoch %lld, offset %d, has offset %d\n", text, parsed, (long long)time.epoch, time.utcOffset, time.hasOffset);
+  }
+  return same;
+}
+
+static bool refused(const char *text) {
+  cydWeeWXTimestamp time;
+  return !parseWeeWXTimestamp(text, time);
+}
+
+static void testIso() {
+  CHECK(parsesTo("2024-11-26T12:40:00-0000", CYD_WWX_TEST_REPORT_EPOCH, 0, true));
+  CHECK(parsesTo("2024-11-26T12:40:00Z", CYD_WWX_TEST_REPORT_EPOCH, 0, true));
+  CHECK(parsesTo("2024-11-26t12:40:00z", CYD_WWX_TEST_REPORT_EPOCH, 0, true));
+  CHECK(parsesTo("2024-11-26T07:40:00-0500", CYD_WWX_TEST_REPORT_EPOCH, -18000, true));
+  CHECK(parsesTo("2024-11-26T07:40:00-05:00", CYD_WWX_TEST_REPORT_EPOCH, -18000, true));
+  CHECK(parsesTo("2024-11-26T18:10:00+0530", CYD_WWX_TEST_REPORT_EPOCH, 19800, true));
+  CHECK(parsesTo("2024-11-26T18:10:00+05:30", CYD_WWX_TEST_REPORT_EPOCH, 19800, true));
+  CHECK(parsesTo("2024-11-27T02:25:00+13:45", CYD_WWX_TEST_REPORT_EPOCH, 49500, true));
+  CHECK(parsesTo("2024-11-26T12:40-0000", CYD_WWX_TEST_REPORT_EPOCH, 0, true));
+
+  // No offset is taken as UTC until the epoch gives it
+  CHECK(parsesTo("2024-11-26T12:40:00", CYD_WWX_TEST_REPORT_EPOCH, 0, false));
+
+  // Calendar edges
+  CHECK(parsesTo("1970-01-01T00:00:00Z", 0, 0, true));
+  CHECK(parsesTo("1969-12-31T23:59:59Z", -1, 0, true));
+  CHECK(parsesTo("2024-02-29T00:00:00Z", 1709164800, 0, true));
+  CHECK(parsesTo("2000-03-01T00:00:00Z", 951868800, 0, true));
+  CHECK(parsesTo("2100-03-01T00:00:00Z", 4107542400, 0, true));
+  CHECK(parsesTo("1999-12-31T23:59:59+0100", 946684799 - 3600, 3600, true));
+  CHECK(parsesTo("2016-12-31T23:59:60Z", 1483228800, 0, true));  // Leap second
+}
+
+static void testHuman() {
+  CHECK(parsesTo("Tue, 26 Nov 2024 12:40:00 GMT", CYD_WWX_TEST_REPORT_EPOCH, 0, false));
+  CHECK(parsesTo("Sun, 01 Dec 2024 00:00:00 EST", 1733011200, 0, false));
+  CHECK(parsesTo("Thu, 29 Feb 2024 23:59:59 AEDT", 1709251199, 0, false));
+
+  // The epoch of the same report gives the offset
+  cydWeeWXTimestamp time;
+  CHECK(parseWeeWXTimestamp("Tue, 26 Nov 2024 07:40:00 EST", time));
+  setUtcOffsetFromEpoch(time, CYD_WWX_TEST_REPORT_EPOCH);
+  CHECK(time.hasOffset);
+  CHECK(time.epoch == CYD_WWX_TEST_REPORT_EPOCH);
+  CHECK(time.utcOffset == -18000);
+  cydWeeWXLocalTime local = getLocalTime(time.localTime());
+  CHECK((local.year == 2024) && (local.month == 11) && (local.day == 26) && (local.secondOfDay == 7 * 3600 + 40 * 60));
+
+  CHECK(parseWeeWXTimestamp("Wed, 27 Nov 2024 01:40:00 NZDT", time));
+  setUtcOffsetFromEpoch(time, CYD_WWX_TEST_REPORT_EPOCH);
+  CHECK(time.utcOffset == 13 * 3600);
+
+  // An offset already known is kept, and a missing epoch changes nothing
+  CHECK(parseWeeWXTimestamp("2024-11-26T07:40:00-0500", time));
+  setUtcOffsetFromEpoch(time, CYD_WWX_TEST_REPORT_EPOCH + 60);
+  CHECK((time.epoch == CYD_WWX_TEST_REPORT_EPOCH) && (time.utcOffset == -18000));
+  CHECK(parseWeeWXTimestamp("Tue, 26 Nov 2024 07:40:00 EST", time));
+  setUtcOffsetFromEpoch(time, 0);
+  CHECK(!time.hasOffset && (time.utcOffset == 0) && (time.epoch == CYD_WWX_TEST_REPORT_EPOCH - 18000));
+}
+
+static void testRefused() {
+  CHECK(refused(nullptr));
+  CHECK(refused(""));
+  CHECK(refused("2024-11-26 12:40:00"));
+  CHECK(refused("2024-11-26T12:40:00+05"));
+  CHECK(refused("2024-11-26T12:40:00+5:30"));
+  CHECK(refused("2024-13-01T00:00:00Z"));
+  CHECK(refused("2024-00-01T00:00:00Z"));
+  CHECK(refused("2024-11-32T00:00:00Z"));
+  CHECK(refused("2024-11-00T00:00:00Z"));
+  CHECK(refused("2024-11-26T24:00:00Z"));
+  CHECK(refused("2024-11-26T12:60:00Z"));
+  CHECK(refused("2024-11-26T12:40:61Z"));
+  CHECK(refused("2024-11-26T12"));
+  CHECK(refused("24-11-26T12:40:00Z"));
+  CHECK(refused("2024/11/26T12:40:00Z"));
+  CHECK(refused("Tue, 26 Foo 2024 12:40:00 EST"));
+  CHECK(refused("Tue, 6 Nov 2024 12:40:00 EST"));
+  CHECK(refused("Tue,26 Nov 2024 12:40:00 EST"));
+  CHECK(refused("Tue, 26 Nov 24 12:40:00 EST"));
+  CHECK(refused("Tue, 26 Nov 2024"));
+  CHECK(refused("N/A"));
+}
+
+static void testTimesOfDay() {
+  const char *text = "06:30 rest";
+  CHECK(parseClockTime(text) == 6 * 3600 + 30 * 60);
+  CHECK_TEXT(text, " rest");
+  text = "23:59:59";
+  CHECK(parseClockTime(text) == 86399);
+  text = "00:00";
+  CHECK(parseClockTime(text) == 0);
+  text = "24:00";
+  CHECK(parseClockTime(text) == -1);
+  text = "6:30";
+  CHECK(parseClockTime(text) == -1);
+  text = "12:60";
+  CHECK(parseClockTime(text) == -1);
+  text = "12-30";
+  CHECK(parseClockTime(text) == -1);
+
+  CHECK(parseAlmanacTime("07:36:04") == 7 * 3600 + 36 * 60 + 4);
+  CHECK(parseAlmanacTime("15:58:08") == 15 * 3600 + 58 * 60 + 8);
+  CHECK(parseAlmanacTime("N/A") == -1);
+  CHECK(parseAlmanacTime("") == -1);
+  CHECK(parseAlmanacTime(nullptr) == -1);
+}
+
+// Random report times written the way WeeWX writes them and read back
+static void testRoundTrip() {
+  std::mt19937_64 random(20241126);
+  std::uniform_int_distribution<int64_t> epochs(-2208988800LL, 7258118399LL);  // 1900 to 2199
+  std::uniform_int_distribution<int> quarterHours(-14 * 4, 14 * 4);
+  int wrong = 0;
+  for (int index = 0; index < CYD_WWX_TEST_ROUND_TRIPS; index++) {
+    int64_t epoch = epochs(random);
+    int32_t utcOffset = quarterHours(random) * 900;
+    time_t local = (time_t)(epoch + utcOffset);
+    struct tm fields;
+    gmtime_r(&local, &fields);
+
+    char text[64];
+    size_t length = strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &fields);
+    int offsetMinutes = abs(utcOffset) / 60;
+    const char *offsetFormat = (index % 2) ? "%c%02d:%02d" : "%c%02d%02d";
+    snprintf(text + length, sizeof(text) - length, offsetFormat, (utcOffset < 0) ? '-' : '+', offsetMinutes / 60, offsetMinutes % 60);
+    cydWeeWXTimestamp time;
+    bool same = parseWeeWXTimestamp(text, time) && (time.epoch == epoch) && (time.utcOffset == utcOffset);
+
+    strftime(text, sizeof(text), "%a, %d %b %Y %H:%M:%S XST", &fields);
+    same = same && parseWeeWXTimestamp(text, time) && (time.epoch == (int64_t)local);
+    if (epoch > 0) {  // An epoch of 0 or less is taken as missing
+      setUtcOffsetFromEpoch(time, epoch);
+      same = same && (time.epoch == epoch) && (time.utcOffset == utcOffset);
+    }
+
+    cydWeeWXLocalTime date = getLocalTime(time.localTime());
+    same = same && (date.year == fields.tm_year + 1900) && (date.month == fields.tm_mon + 1) && (date.day == fields.tm_mday)
+      && (date.secondOfDay == fields.tm_hour * 3600 + fields.tm_min * 60 + fields.tm_sec);
+    same = same && (daysFromCivil(date.year, date.month, date.day) * CYD_WWX_SECONDS_PER_DAY + date.secondOfDay == (int64_t)local);
+    if (!same && (++wrong <= 10)) {
+      printf("  epoch %lld offset %d: \"%s\"\n", (long long)epoch, utcOffset, text);
+    }
+  }
+  CHECK(wrong == 0);
+}
+
+static void benchmark() {
+  const char *report = "2024-11-26T07:40:00-0500";
+  int64_t total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < CYD_WWX_TEST_PARSES; index++) {
+    cydWeeWXTimestamp time;
+    parseWeeWXTimestamp(report, time);
+    total += time.epoch;
+  }
+  double parseTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_PARSES;
+
+  start = std::chrono::steady_clock::now();
+  for (int index = 0; index < CYD_WWX_TEST_PARSES; index++) {
+    struct tm fields = {};
+    char sign;
+    int offset;
+    sscanf(report, "%4d-%2d-%2dT%2d:%2d:%2d%c%4d", &fields.tm_year, &fields.tm_mon, &fields.tm_mday,
+           &fields.tm_hour, &fields.tm_min, &fields.tm_sec, &sign, &offset);
+    fields.tm_year -= 1900;
+    fields.tm_mon -= 1;
+    int utcOffset = ((offset / 100) * 3600 + (offset % 100) * 60) * ((sign == '-') ? -1 : 1);
+    total -= timegm(&fields) - utcOffset;
+  }
+  double scanTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CYD_WWX_TEST_PARSES;
+
+  CHECK(total == 0);
+  printf("Report time parsed with parseWeeWXTimestamp: %.0f ns, with sscanf and timegm: %.0f ns.\n", parseTime, scanTime);
+}
+
+int main() {
+  testIso();
+  testHuman();
+  testRefused();
+  testTimesOfDay();
+  testRoundTrip();
+  benchmark();
+  return cydWeeWXTestResult();
+}
@@ -0,0 +1,95 @@
+// **********************************************************************************
+// ** Host test for cydWeeWXClassifyWmo
+// ** Labelled station readings and the WMO code each should give. The labels are the
+// ** weather a person at the station would report. Readings either side of each
+// ** threshold check where one code changes to the next.
+// **********************************************************************************
+// ** Project details at https://github.com/hcomet/cydWeeWX
+// ** (c) Copyright Stephen Hillier 2024. All Rights Reserved.
+// **********************************************************************************
+
+#include "cydWeeWXWmo.h"
+#include "cydWeeWXTest.h"
+
+struct cydWeeWXWmoFixture {
+  const char *label;
+  float temperature;
+  float humidity;
+  float rainRate;
+  float pressureTrend;
+  bool isDay;
+  int wmoCode;
+};
+
+static const cydWeeWXWmoFixture fixtures[] = {
+  // Dry weather, cloud from the humidity and the barometer
+  {"Dry sunny afternoon",                 24.0f, 35.0f,  0.0f,  0.2f,  true,  0},
+  {"Humid but clear morning",             18.0f, 65.0f,  0.0f,  0.0f,  true,  1},
+  {"Cloud building",                      16.0f, 80.0f,  0.0f,  0.0f,  true,  2},
+  {"Grey overcast day",                   12.0f, 92.0f,  0.0f,  0.0f,  true,  3},
+  {"Clear night with dew forming",        10.0f, 78.0f,  0.0f,  0.0f,  false, 1},
+  {"Cloudy night",                        10.0f, 86.0f,  0.0f,  0.0f,  false, 2},
+  {"Front coming, barometer falling",     20.0f, 50.0f,  0.0f, -0.6f,  true,  2},
+  {"Storm coming, barometer dropping",    20.0f, 50.0f,  0.0f, -1.2f,  true,  3},
+  {"Station without a barometer",         20.0f, 50.0f,  0.0f,   NAN,  true,  0},
+  {"Station without a rain gauge",        20.0f, 50.0f,   NAN,  0.0f,  true,  0},
+
+  // Fog needs saturated air
+  {"Valley fog at dawn",                   6.0f, 99.0f,  0.0f,  0.0f,  false, 45},
+  {"Fog with the humidity sensor over",    6.0f, 102.0f, 0.0f,  0.0f,  true,  45},
+  {"Damp but not fog",                     6.0f, 96.0f,  0.0f,  0.0f,  true,  3},
+
+  // Rain by rate
+  {"Light drizzle",                       12.0f, 95.0f,  0.1f,  0.0f,  true,  51},
+  {"Drizzle",                             12.0f, 95.0f,  0.3f,  0.0f,  true,  53},
+  {"Light rain",                          12.0f, 95.0f,  1.0f,  0.0f,  true,  61},
+  {"Steady rain",                         12.0f, 95.0f,  5.0f,  0.0f,  true,  63},
+  {"Heavy rain",                          12.0f, 95.0f, 20.0f,  0.0f,  true,  65},
+  {"Cloudburst",                          22.0f, 95.0f, 80.0f, -2.0f,  true,  82},
+
+  // Freezing and frozen
+  {"Freezing drizzle",                     0.0f, 95.0f,  0.2f,  0.0f,  true,  56},
+  {"Freezing rain",                        0.0f, 95.0f,  1.0f,  0.0f,  true,  66},
+  {"Heavy freezing rain",                 -1.0f, 95.0f,  4.0f,  0.0f,  true,  67},
+  {"Light snow",                          -5.0f, 90.0f,  0.5f,  0.0f,  true,  71},
+  {"Snow",                                -5.0f, 90.0f,  2.0f,  0.0f,  false, 73},
+  {"Heavy snow",                          -8.0f, 90.0f,  6.0f,  0.0f,  true,  75},
+
+  // Threshold edges
+  {"Rain rate just above zero",           12.0f, 40.0f, 0.01f,  0.0f,  true,  51},
+  {"Drizzle to rain at 0.5 mm/h",         12.0f, 95.0f,  0.5f,  0.0f,  true,  61},
+  {"Rain to heavy rain at 7.6 mm/h",      12.0f, 95.0f,  7.6f,  0.0f,  true,  65},
+  {"Rain to showers at 50 mm/h",          12.0f, 95.0f, 50.0f,  0.0f,  true,  82},
+  {"Just above freezing is rain",          0.6f, 95.0f,  1.0f,  0.0f,  true,  61},
+  {"At -2 C is still freezing rain",      -2.0f, 95.0f,  1.0f,  0.0f,  true,  66},
+  {"Mainly clear from 60 %",              20.0f, 60.0f,  0.0f,  0.0f,  true,  1},
+  {"Clear just below 60 %",               20.0f, 59.9f,  0.0f,  0.0f,  true,  0},
+  {"Partly cloudy from 75 %",             20.0f, 75.0f,  0.0f,  0.0f,  true,  2},
+  {"Overcast from 90 %",                  20.0f, 90.0f,  0.0f,  0.0f,  true,  3},
+  {"Night takes 5 % off the humidity",    20.0f, 94.0f,  0.0f,  0.0f,  false, 2},
+
+  // Not enough readings
+  {"No temperature",                        NAN, 50.0f,  0.0f,  0.0f,  true,  -1},
+  {"No humidity",                         20.0f,   NAN,  0.0f,  0.0f,  true,  -1},
+  {"Humidity sensor reading zero",        20.0f,  0.0f,  0.0f,  0.0f,  true,  -1},
+};
+
+int main() {
+  for (const cydWeeWXWmoFixture &fixture : fixtures) {
+    cydWeeWXStationReadings readings;
+    readings.temperature = fixture.temperature;
+    readings.humidity = fixture.humidity;
+    readings.rainRate = fixture.rainRate;
+    readings.pressureTrend = fixture.pressureTrend;
+    readings.isDay = fixture.isDay;
+    int wmoCode = cydWeeWXClassifyWmo(readings);
+    if (!CHECK(wmoCode == fixture.wmoCode)) {
+      printf("  %s: got %d, expected %d\n", fixture.label, wmoCode, fixture.wmoCode);
+    }
+  }
+
+  // Dewpoint equals the temperature in saturated air and is about 10 C at 20 C and 52 %
+  CHECK(fabsf(cydWeeWXDewpoint(15.0f, 100.0f) - 15.0f) < 0.01f);
+  CHECK(fabsf(cydWeeWXDewpoint(20.0f, 52.0f) - 9.9f) < 0.2f);
+  return cydWeeWXTestResult();
+}